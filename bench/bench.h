@@ -0,0 +1,174 @@
+#ifndef ZBOR_BENCH_H
+#define ZBOR_BENCH_H
+
+#include "zbor/reflect.h"
+#include "utl/time.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Run function N times and print total execution time.
+ * 
+ * @tparam N Number of calls
+ * @param name Name of the case
+ * @param fn Function to measure
+ */
+template<size_t N, class Fn>
+void bench(const char* name, Fn&& fn)
+{
+    printf("%-48s %8ld clock_t\n", name, utl::exec_time<N>(fn));
+}
+
+/**
+ * @brief Run function N times and print total wall time, for cases running 
+ * on multiple threads, where clock_t sums time of all of them.
+ * 
+ * @tparam N Number of calls
+ * @param name Name of the case
+ * @param fn Function to measure
+ */
+template<size_t N, class Fn>
+void bench_wall(const char* name, Fn&& fn)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < N; ++i)
+        fn();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+    printf("%-48s %8ld us wall\n", name, long(us.count()));
+}
+
+/**
+ * @brief Prevent compiler from optimizing away computation of a value.
+ * 
+ * @param val Any value
+ */
+template<class T>
+void keep(const T& val)
+{
+    asm volatile("" : : "g"(&val) : "memory");
+}
+
+/**
+ * @brief Encode typical telemetry document: array of records, each is 
+ * a map with timestamp, float value, short array of samples, name and flag.
+ * 
+ * @param doc Any codec
+ * @param records Number of records
+ * @return Error status
+ */
+template<class C>
+zbor::err telemetry(C& doc, size_t records)
+{
+    using namespace std::literals;
+
+    zbor::err e = doc.encode_arr(records);
+
+    for (size_t i = 0; i < records && e == zbor::err_ok; ++i) {
+        e = doc.encode_map(5);
+        e = e ? e : doc.encode_("ts"sv, uint64_t(1600000000000 + i * 1000));
+        e = e ? e : doc.encode_("val"sv, float(i) * 0.25f);
+        e = e ? e : doc.encode_("seq"sv);
+        e = e ? e : doc.encode_arr(4);
+        for (size_t j = 0; j < 4 && e == zbor::err_ok; ++j)
+            e = doc.encode_sint(int64_t(i * j % 300) - 100);
+        e = e ? e : doc.encode_("name"sv, "sensor"sv);
+        e = e ? e : doc.encode_("ok"sv, i % 3 == 0);
+    }
+    return e;
+}
+
+/**
+ * @brief Telemetry record, see telemetry(doc, records).
+ * 
+ */
+struct sample {
+    uint64_t ts;
+    float val;
+    std::array<int64_t, 4> seq;
+    std::string_view name;
+    bool ok;
+};
+ZBOR_FIELDS(sample, ts, val, seq, name, ok)
+
+/**
+ * @brief Generate telemetry document, see telemetry(doc, records).
+ * 
+ * @param records Number of records
+ * @return Encoded CBOR
+ */
+inline std::vector<zbor::byte> telemetry(size_t records)
+{
+    std::vector<zbor::byte> buf(records * 64 + 16);
+    zbor::view doc{buf};
+
+    telemetry(doc, records);
+
+    buf.resize(doc.size());
+    return buf;
+}
+
+/**
+ * @brief Generate document with randomly mixed item types: small and large 
+ * integers, short strings, floats, simple values and small containers.
+ * 
+ * @param items Number of items
+ * @return Encoded CBOR
+ */
+inline std::vector<zbor::byte> mixed(size_t items)
+{
+    using namespace std::literals;
+
+    std::vector<zbor::byte> buf(items * 16 + 16);
+    zbor::view doc{buf};
+    std::mt19937 rng{1};
+
+    doc.encode_arr(items);
+
+    for (size_t i = 0; i < items; ++i) {
+        switch (rng() % 8)
+        {
+        case 0: doc.encode_uint(rng() % 24); break;
+        case 1: doc.encode_uint(rng()); break;
+        case 2: doc.encode_sint(-int64_t(rng() % 1000)); break;
+        case 3: doc.encode_("abc"sv); break;
+        case 4: doc.encode_(double(rng()) * 0.1); break;
+        case 5: doc.encode_(rng() % 2 == 0); break;
+        case 6: doc.encode_arr(2); doc.encode_(1u, 300u); break;
+        case 7: doc.encode_map(1); doc.encode_("k"sv, uint64_t(rng() % 24)); break;
+        }
+    }
+    buf.resize(doc.size());
+    return buf;
+}
+
+/**
+ * @brief Generate array of single-byte scalars: small integers, as produced 
+ * by sensors, or booleans, as bitmap.
+ * 
+ * @param items Number of items
+ * @param bits Encode booleans instead of integers
+ * @return Encoded CBOR
+ */
+inline std::vector<zbor::byte> scalars(size_t items, bool bits)
+{
+    std::vector<zbor::byte> buf(items + 16);
+    zbor::view doc{buf};
+
+    doc.encode_arr(items);
+
+    for (size_t i = 0; i < items; ++i) {
+        if (bits)
+            doc.encode_(i % 3 == 0);
+        else
+            doc.encode_sint(int64_t(i % 40) - 20);
+    }
+    buf.resize(doc.size());
+    return buf;
+}
+
+void bench_dec();
+void bench_enc();
+
+#endif
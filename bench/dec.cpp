@@ -0,0 +1,422 @@
+#include "bench.h"
+#include "zbor/compact.h"
+#include "zbor/mapped.h"
+#include "zbor/parallel.h"
+#include "zbor/sax.h"
+#include "zbor/typed.h"
+#include <atomic>
+
+namespace {
+
+using namespace zbor;
+
+/**
+ * @brief Switch-based skip loop, as it was before dec::heads table, 
+ * kept as reference.
+ * 
+ */
+std::tuple<err, pointer> skip_switch(pointer p, const pointer end, uint64_t skip, size_t nest)
+{
+    byte mt;
+    uint64_t val;
+    err e;
+
+    while (skip || nest) {
+
+        if (p >= end)
+            return {err_out_of_bounds, end};
+
+        mt  = *p   & 0xe0;
+        val = *p++ & 0x1f;
+
+        if (val == ai_indef) {
+            switch (mt) {
+            case mt_data:
+            case mt_text:
+            case mt_array:
+            case mt_map: ++nest; 
+            break;
+            case mt_simple:
+                if (!nest)
+                    return {err_invalid_break, p};
+                --nest;
+            break;
+            default: return {err_invalid_indef_mt, p};
+            }
+        } else {
+            std::tie(e, val, p) = dec::ai_check(val, p, end);
+
+            if (e != err_ok) 
+                return {e, p};
+                
+            switch (mt) {
+            case mt_data:
+            case mt_text:   
+                if (p + val > end)
+                    return {err_out_of_bounds, p};
+                p += val; 
+            break;
+            case mt_array:  if (!nest) skip += val;         break;
+            case mt_map:    if (!nest) skip += val << 1;    break;
+            case mt_tag:    if (!nest) skip += 1;           break;
+            }
+        }
+        if (skip && !nest)
+            skip--;
+    }
+    return {err_ok, p};
+}
+
+/**
+ * @brief Handwritten decoding of telemetry record, comparing keys one by one.
+ *
+ */
+void decode_sample(const item& rec, sample& out)
+{
+    using namespace std::literals;
+
+    for (auto [key, val] : rec.map) {
+        if (key.text == "ts"sv)
+            out.ts = val.uint;
+        else if (key.text == "val"sv)
+            out.val = val.fp;
+        else if (key.text == "seq"sv) {
+            size_t i = 0;
+            for (auto s : val.arr)
+                out.seq[i++ & 3] = s.sint;
+        }
+        else if (key.text == "name"sv)
+            out.name = {reinterpret_cast<const char*>(val.text.data()), val.text.size()};
+        else if (key.text == "ok"sv)
+            out.ok = val.prim == prim_true;
+    }
+}
+
+/**
+ * @brief Recursive traversal of every nested item, as messages were validated
+ * before zbor::validate(), containers are decoded again on every level.
+ *
+ */
+size_t walk(const item& obj)
+{
+    size_t n = 1;
+    switch (obj.type)
+    {
+    case type_array:
+        for (auto val : obj.arr)
+            n += walk(val);
+    break;
+    case type_map:
+        for (auto [key, val] : obj.map)
+            n += walk(key) + walk(val);
+    break;
+    case type_tag:
+        n += walk(obj.tag.content());
+    break;
+    default:;
+    }
+    return n;
+}
+
+}
+
+void bench_dec()
+{
+    static constexpr auto count = 200;
+
+    const auto doc = telemetry(10000);
+    const auto begin = doc.data();
+    const auto end = doc.data() + doc.size();
+
+    const auto mix = mixed(40000);
+    const auto mix_begin = mix.data();
+    const auto mix_end = mix.data() + mix.size();
+
+    const auto sensor = scalars(100000, false);
+    const auto bitmap = scalars(100000, true);
+
+    printf("+---------------------DECODE---------------------+\n");
+    printf("telemetry: %zu bytes, mixed: %zu bytes, %d runs \n", doc.size(), mix.size(), count);
+
+    bench<count>("skip telemetry: switch", [&] {
+        keep(skip_switch(begin, end, 1, 0));
+    });
+    bench<count>("skip telemetry: table", [&] {
+        keep(dec::skip(begin, end, 1, 0));
+    });
+    bench<count>("skip mixed: switch", [&] {
+        keep(skip_switch(mix_begin, mix_end, 1, 0));
+    });
+    bench<count>("skip mixed: table", [&] {
+        keep(dec::skip(mix_begin, mix_end, 1, 0));
+    });
+    bench<count>("skip sensor array: switch", [&] {
+        keep(skip_switch(sensor.data(), sensor.data() + sensor.size(), 1, 0));
+    });
+    bench<count>("skip sensor array: table + scalar runs", [&] {
+        keep(dec::skip(sensor.data(), sensor.data() + sensor.size(), 1, 0));
+    });
+    bench<count>("skip bitmap: switch", [&] {
+        keep(skip_switch(bitmap.data(), bitmap.data() + bitmap.size(), 1, 0));
+    });
+    bench<count>("skip bitmap: table + scalar runs", [&] {
+        keep(dec::skip(bitmap.data(), bitmap.data() + bitmap.size(), 1, 0));
+    });
+    bench<count>("validate telemetry: recursive decode", [&] {
+        keep(walk(std::get<item>(decode(begin, end))));
+    });
+    bench<count>("validate telemetry: validate", [&] {
+        keep(validate(doc));
+    });
+    bench<count>("validate mixed: recursive decode", [&] {
+        keep(walk(std::get<item>(decode(mix_begin, mix_end))));
+    });
+    bench<count>("validate mixed: validate", [&] {
+        keep(validate(mix));
+    });
+    bench<count>("validate sensor array: recursive decode", [&] {
+        keep(walk(std::get<item>(decode(sensor.data(), sensor.data() + sensor.size()))));
+    });
+    bench<count>("validate sensor array: validate", [&] {
+        keep(validate(sensor));
+    });
+    // Worst case inputs of public endpoint, limited decoding must reject them 
+    // in time bounded by limits instead of input size
+    const limits lim{.depth = 32, .length = 100000, .string = 1 << 20, .items = 1000000};
+    std::vector<byte> deep(1 << 20, 0x9f);
+    std::vector<byte> wide{0x9a, 0x00, 0x10, 0x00, 0x00};
+    wide.resize(5 + (1 << 20), 0x80);
+    const std::vector<byte> huge{0xbb, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00};
+    // Random byte flips of mixed document
+    std::vector<std::vector<byte>> fuzz(16, mix);
+    std::mt19937 rng{7};
+    for (auto& f : fuzz) {
+        for (int i = 0; i < 4; ++i)
+            f[rng() % f.size()] = byte(rng());
+    }
+    auto reject = [&](const char* name, const std::vector<byte>& in, auto fn) {
+        bench<count>(name, [&] {
+            keep(fn(in.data(), in.data() + in.size()));
+        });
+    };
+    auto unlimited = [](pointer p, pointer end) { return decode(p, end); };
+    auto limited = [&](pointer p, pointer end) { return decode(p, end, lim); };
+
+    reject("worst: 1 MB of 0x9f, decode", deep, unlimited);
+    reject("worst: 1 MB of 0x9f, decode with limits", deep, limited);
+    reject("worst: 2^20 element array, decode", wide, unlimited);
+    reject("worst: 2^20 element array, decode with limits", wide, limited);
+    reject("worst: 2^63 pair map, decode", huge, unlimited);
+    reject("worst: 2^63 pair map, decode with limits", huge, limited);
+    bench<count>("fuzz: 16 mutated docs, decode", [&] {
+        for (auto& f : fuzz)
+            keep(decode(f.data(), f.data() + f.size()));
+    });
+    bench<count>("fuzz: 16 mutated docs, decode with limits", [&] {
+        for (auto& f : fuzz)
+            keep(decode(f.data(), f.data() + f.size(), lim));
+    });
+    bench<count>("fuzz: 16 mutated docs, validate", [&] {
+        for (auto& f : fuzz)
+            keep(validate(f, lim));
+    });
+    bench<count>("traverse: decode", [&] {
+        uint64_t n = 0;
+        auto root = std::get<item>(decode(begin, end));
+        for (auto rec : root.arr)
+            for (auto [key, val] : rec.map)
+                n += val.type;
+        keep(n);
+    });
+    bench<count>("traverse: decode_lazy", [&] {
+        uint64_t n = 0;
+        auto root = std::get<item>(decode_lazy(begin, end));
+        for (auto rec : root.arr)
+            for (auto [key, val] : rec.map)
+                n += val.type;
+        keep(n);
+    });
+    bench<count>("traverse: compact", [&] {
+        uint64_t n = 0;
+        compact::seq in{doc};
+        auto root = *in.begin();
+        for (auto rec : in.arr(root))
+            for (auto [key, val] : in.map(rec))
+                n += val.type;
+        keep(n);
+    });
+    bench<count>("traverse: sax", [&] {
+        struct {
+            uint64_t n = 0;
+            void on_uint(uint64_t)  { n += type_uint; }
+            void on_sint(int64_t)   { n += type_sint; }
+            void on_float(double)   { n += type_floating; }
+            void on_prim(prim)      { n += type_prim; }
+            void on_text(dec::txt)  { n += type_text; }
+        } v;
+        keep(parse(begin, end, v));
+        keep(v.n);
+    });
+    bench<count>("struct: handwritten map loop", [&] {
+        sample out{};
+        auto root = std::get<item>(decode_lazy(begin, end));
+        for (auto rec : root.arr) {
+            decode_sample(rec, out);
+            keep(out);
+        }
+    });
+    bench<count>("struct: decode_into", [&] {
+        sample out{};
+        auto root = std::get<item>(decode_lazy(begin, end));
+        for (auto rec : root.arr) {
+            keep(decode_into(rec, out));
+            keep(out);
+        }
+    });
+    std::vector<float> samples(1000000);
+    for (size_t i = 0; i < samples.size(); ++i)
+        samples[i] = float(i % 1000) * 0.37f;
+
+    std::vector<byte> plain(samples.size() * 5 + 16), packed(samples.size() * 4 + 16);
+    view plain_doc{plain}, packed_doc{packed};
+    plain_doc.encode_array(samples);
+    // Payload follows tag (2) and head (5), one byte of prefix aligns it
+    packed_doc.encode_uint(0);
+    encode_typed(packed_doc, samples);
+    const seq packed_seq{packed.data(), packed_doc.size()};
+    std::vector<float> copy(samples.size());
+
+    bench<count / 10>("float array: seq_iter, 1M", [&] {
+        float sum = 0;
+        auto root = std::get<item>(decode_lazy(plain.data(), plain.data() + plain_doc.size()));
+        for (auto val : root.arr)
+            sum += val.fp;
+        keep(sum);
+    });
+    bench<count / 10>("typed array: typed_copy, 1M", [&] {
+        float sum = 0;
+        keep(typed_copy<float>(*++packed_seq.begin(), copy));
+        for (float f : copy)
+            sum += f;
+        keep(sum);
+    });
+    bench<count / 10>("typed array: typed_view, 1M", [&] {
+        float sum = 0;
+        auto [elems, e] = typed_view<float>(*++packed_seq.begin());
+        for (float f : elems)
+            sum += f;
+        keep(sum);
+    });
+    // float16 little endian
+    std::vector<byte> halves{0xd8, 84, 0x5a, 0x00, 0x1e, 0x84, 0x80};
+    for (float f : samples) {
+        uint16_t h = utl::float_to_half(std::bit_cast<uint32_t>(f));
+        halves.push_back(h);
+        halves.push_back(h >> 8);
+    }
+    const auto half_arr = std::get<item>(decode(halves.data(), halves.data() + halves.size()));
+
+    bench<count / 10>("typed float16 array: typed_copy, 1M", [&] {
+        keep(typed_copy<float>(half_arr, copy));
+        keep(copy[0]);
+    });
+    bench<count>("traverse mixed: decode_lazy", [&] {
+        uint64_t n = 0;
+        auto root = std::get<item>(decode_lazy(mix_begin, mix_end));
+        for (auto val : root.arr)
+            n += val.type;
+        keep(n);
+    });
+    bench<count>("traverse mixed: compact", [&] {
+        uint64_t n = 0;
+        compact::seq in{mix};
+        for (auto val : in.arr(*in.begin()))
+            n += val.type;
+        keep(n);
+    });
+    // Firmware blob: 64 KB in chunks of 16 to 271 bytes
+    std::vector<byte> blob(80000), whole(65536);
+    view blob_doc{blob};
+    blob_doc.encode_(enc::indef_dat());
+    for (size_t i = 0, len; i < whole.size(); i += len) {
+        len = std::min<size_t>(16 + i % 256, whole.size() - i);
+        blob_doc.encode(span{reinterpret_cast<pointer>(samples.data()) + i, len});
+    }
+    blob_doc.encode_(enc::breaker());
+    const auto blob_str = std::get<item>(decode(blob.data(), blob.data() + blob_doc.size())).istr;
+
+    bench<count>("indefinite blob: seq_iter + concat, 64KB", [&] {
+        size_t n = 0;
+        for (auto chunk : blob_str) {
+            std::copy_n(chunk.data.data(), chunk.data.size(), whole.data() + n);
+            n += chunk.data.size();
+        }
+        keep(whole[n - 1]);
+    });
+    bench<count>("indefinite blob: copy_to, 64KB", [&] {
+        keep(blob_str.copy_to(whole));
+        keep(whole[0]);
+    });
+    // Archive of records as CBOR sequence, about 14 MB
+    const char* archive = "/tmp/zbor_bench.cborseq";
+    if (FILE* f = fopen(archive, "wb")) {
+        for (int i = 0; i < 64; ++i)
+            fwrite(begin + 3, 1, doc.size() - 3, f);
+        fclose(f);
+    }
+    bench<count / 20>("archive: fread + seq", [&] {
+        uint64_t n = 0;
+        if (FILE* f = fopen(archive, "rb")) {
+            std::vector<byte> buf(64 * doc.size());
+            size_t len = fread(buf.data(), 1, buf.size(), f);
+            fclose(f);
+            for (auto& obj : seq{buf.data(), len})
+                n += obj.type;
+        }
+        keep(n);
+    });
+    bench<count / 20>("archive: mapped_seq", [&] {
+        uint64_t n = 0;
+        mapped_seq in{archive};
+        for (auto [obj, off] : in)
+            n += obj.type + off;
+        keep(n);
+    });
+    bench<count / 20>("archive: mapped_seq, 1MB window", [&] {
+        uint64_t n = 0;
+        mapped_seq in{archive, 1 << 20};
+        for (auto [obj, off] : in)
+            n += obj.type + off;
+        keep(n);
+    });
+    remove(archive);
+
+    std::vector<byte> records;
+    for (int i = 0; i < 64; ++i)
+        records.insert(records.end(), begin + 3, end);
+    const seq records_seq{records.data(), records.size()};
+
+    bench_wall<count / 50>("records: seq + decode_into", [&] {
+        sample out;
+        size_t n = 0;
+        for (auto& obj : records_seq)
+            n += decode_into(obj, out) == err_ok;
+        keep(n);
+    });
+    bench_wall<count / 50>("records: parallel_for_each, unordered", [&] {
+        std::atomic<size_t> n = 0;
+        parallel_for_each(records_seq, [&](const item& obj, size_t) {
+            sample out;
+            n += decode_into(obj, out) == err_ok;
+        });
+        keep(n);
+    });
+    bench_wall<count / 50>("records: parallel_for_each, ordered", [&] {
+        sample out;
+        size_t n = 0;
+        parallel_for_each(records_seq, [&](const item& obj, size_t) {
+            n += decode_into(obj, out) == err_ok;
+        }, {0, size_t(1) << 20, par_ordered});
+        keep(n);
+    });
+}
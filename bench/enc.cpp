@@ -0,0 +1,206 @@
+#include "bench.h"
+#include "zbor/dynamic.h"
+#include "zbor/gather.h"
+
+namespace {
+
+using namespace zbor;
+using namespace zbor::literals;
+
+/**
+ * @brief Same document as telemetry(), but constant parts of every record 
+ * are pre-encoded at compile time.
+ * 
+ */
+template<class C>
+err telemetry_frag(C& doc, size_t records)
+{
+    static constexpr auto head  = fragment<5_map, "ts"_txt>;
+    static constexpr auto val   = fragment<"val"_txt>;
+    static constexpr auto seq   = fragment<"seq"_txt, 4_arr>;
+    static constexpr auto name  = fragment<"name"_txt, "sensor"_txt, "ok"_txt>;
+
+    err e = doc.encode_arr(records);
+
+    for (size_t i = 0; i < records && e == err_ok; ++i) {
+        e = doc.encode_(head, uint64_t(1600000000000 + i * 1000), val, float(i) * 0.25f, seq);
+        for (size_t j = 0; j < 4 && e == err_ok; ++j)
+            e = doc.encode_sint(int64_t(i * j % 300) - 100);
+        e = e ? e : doc.encode_(name, i % 3 == 0);
+    }
+    return e;
+}
+
+}
+
+void bench_enc()
+{
+    static constexpr auto count = 200;
+    static constexpr auto records = 10000;
+
+    printf("+---------------------ENCODE---------------------+\n");
+    printf("telemetry: %d records, %d runs \n", records, count);
+
+    std::vector<byte> out(records * 64);
+
+    bench<count>("view: exact size", [&] {
+        std::vector<byte> buf(records * 64);
+        view doc{buf};
+        keep(telemetry(doc, records));
+        keep(doc.size());
+    });
+    bench<count>("view: preallocated", [&] {
+        view doc{out};
+        keep(telemetry(doc, records));
+        keep(doc.size());
+    });
+    bench<count>("view: preallocated, fragments", [&] {
+        view doc{out};
+        keep(telemetry_frag(doc, records));
+        keep(doc.size());
+    });
+    bench<count>("view: preallocated, reflected struct", [&] {
+        view doc{out};
+        err e = doc.encode_arr(records);
+        for (size_t i = 0; i < records && e == err_ok; ++i) {
+            sample rec{1600000000000 + i * 1000, float(i) * 0.25f, {}, "sensor", i % 3 == 0};
+            for (size_t j = 0; j < 4; ++j)
+                rec.seq[j] = int64_t(i * j % 300) - 100;
+            e = encode(doc, rec);
+        }
+        keep(e);
+        keep(doc.size());
+    });
+    bench<count>("view: double and retry from 256 bytes", [&] {
+        std::vector<byte> buf(256);
+        while (true) {
+            view doc{buf};
+            if (telemetry(doc, records) == err_ok) {
+                keep(doc.size());
+                break;
+            }
+            buf.resize(buf.size() * 2);
+        }
+    });
+    bench<count>("dynamic_codec: grow from empty", [&] {
+        dynamic_codec doc;
+        keep(telemetry(doc, records));
+        keep(doc.size());
+    });
+    bench<count>("dynamic_codec: reserved", [&] {
+        dynamic_codec doc{records * 64};
+        keep(telemetry(doc, records));
+        keep(doc.size());
+    });
+
+    // Message with large binary payload
+    std::vector<float> samples(100000);
+    std::vector<int32_t> counts(100000);
+    std::mt19937 rng{1};
+    for (size_t i = 0; i < samples.size(); ++i) {
+        // Mostly sensor readings with few fractional bits, some need single precision
+        samples[i] = i % 4 ? float(rng() % 4096) * 0.125f : float(rng()) * 1e-3f;
+        counts[i] = int32_t(rng() % 64) - 16;
+    }
+
+    bench<count>("float samples: encode_float", [&] {
+        view doc{out};
+        doc.encode_arr(samples.size());
+        for (float f : samples)
+            doc.encode_float(f);
+        keep(doc.size());
+    });
+    bench<count>("float samples: encode_array", [&] {
+        view doc{out};
+        keep(doc.encode_array(samples));
+        keep(doc.size());
+    });
+    // Shortest width selection: random bit patterns mostly need full width, 
+    // nice values (small integers and halves) fit into half precision
+    std::vector<float> random_f(100000), nice_f(100000);
+    std::vector<double> random_d(100000), nice_d(100000);
+    for (size_t i = 0; i < random_f.size(); ++i) {
+        random_f[i] = std::ldexp(float(rng()) / 4294967296.0f + 1.0f, int(rng() % 64) - 32);
+        random_d[i] = std::ldexp(double(rng()) / 4294967296.0 + 1.0, int(rng() % 64) - 32);
+        nice_f[i] = float(rng() % 2048) * 0.5f;
+        nice_d[i] = nice_f[i];
+    }
+    auto floats = [&](const char* name, const auto& val, auto encode) {
+        bench<count>(name, [&] {
+            view doc{out};
+            doc.encode_arr(val.size());
+            for (auto v : val)
+                encode(doc, v);
+            keep(doc.size());
+        });
+    };
+    floats("random floats: encode_float", random_f, [](view& doc, float v) { doc.encode_float(v); });
+    floats("random floats: encode_float32", random_f, [](view& doc, float v) { doc.encode_float32(v); });
+    floats("nice floats: encode_float", nice_f, [](view& doc, float v) { doc.encode_float(v); });
+    floats("random doubles: encode_double", random_d, [](view& doc, double v) { doc.encode_double(v); });
+    floats("random doubles: encode_float64", random_d, [](view& doc, double v) { doc.encode_float64(v); });
+    floats("nice doubles: encode_double", nice_d, [](view& doc, double v) { doc.encode_double(v); });
+
+    bench<count>("int samples: encode_sint", [&] {
+        view doc{out};
+        doc.encode_arr(counts.size());
+        for (int32_t c : counts)
+            doc.encode_sint(c);
+        keep(doc.size());
+    });
+    bench<count>("int samples: encode_array", [&] {
+        view doc{out};
+        keep(doc.encode_array(counts));
+        keep(doc.size());
+    });
+
+    std::vector<byte> blob(4 << 20, 0xab);
+    out.resize(blob.size() + 64);
+    iovec vec[8];
+
+    bench<count>("4 MB blob: view", [&] {
+        view doc{out};
+        keep(doc.encode_(enc::map(2), 1, 42, 2, span{blob}));
+        keep(doc.size());
+    });
+    bench<count>("4 MB blob: gather_view", [&] {
+        gather_view doc{out, vec};
+        keep(doc.encode_(enc::map(2), 1, 42, 2, span{blob}));
+        keep(doc.iov());
+    });
+
+    // Rows of unknown count: indefinite array versus deferred length
+    std::vector<byte> indef(records * 8), deferred(records * 8);
+    view rows_indef{indef}, rows_deferred{deferred};
+
+    bench<count>("rows: indef_arr + breaker", [&] {
+        rows_indef.clear();
+        rows_indef.encode_indef_arr();
+        for (size_t i = 0; i < records; ++i)
+            rows_indef.encode_(enc::arr(2), i, i * 1000);
+        rows_indef.encode_break();
+        keep(rows_indef.size());
+    });
+    bench<count>("rows: begin_arr + end", [&] {
+        rows_deferred.clear();
+        auto arr = rows_deferred.begin_arr(records);
+        for (size_t i = 0; i < records; ++i)
+            rows_deferred.encode_(enc::arr(2), i, i * 1000);
+        keep(arr.end());
+        keep(rows_deferred.size());
+    });
+    bench<count>("rows: begin_arr + end(count)", [&] {
+        rows_deferred.clear();
+        auto arr = rows_deferred.begin_arr(records);
+        for (size_t i = 0; i < records; ++i)
+            rows_deferred.encode_(enc::arr(2), i, i * 1000);
+        keep(arr.end(records));
+        keep(rows_deferred.size());
+    });
+    bench<count>("rows: skip indefinite", [&] {
+        keep(dec::skip(rows_indef.data(), rows_indef.data() + rows_indef.size(), 1, 0));
+    });
+    bench<count>("rows: skip definite", [&] {
+        keep(dec::skip(rows_deferred.data(), rows_deferred.data() + rows_deferred.size(), 1, 0));
+    });
+}
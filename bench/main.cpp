@@ -0,0 +1,7 @@
+#include "bench.h"
+
+int main(int, char**)
+{
+    bench_dec();
+    bench_enc();
+}
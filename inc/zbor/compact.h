@@ -0,0 +1,319 @@
+#ifndef ZBOR_COMPACT_H
+#define ZBOR_COMPACT_H
+
+#include "zbor/dec.h"
+
+namespace zbor {
+namespace compact {
+
+/**
+ * @brief Compact decoded CBOR object: pointer past head, low 32 bits of
+ * argument and packed type, 16 bytes instead of 40 of zbor::item. Arguments
+ * which don't fit into 32 bits are read again from input when needed. Bounds
+ * of containers aren't stored, their elements are traversed with ranges of
+ * compact::seq, which holds end of input.
+ *
+ */
+struct item {
+    pointer ptr     = nullptr;      // Past head: payload of strings, first nested item of containers and tags
+    uint32_t len    = 0;            // Argument, only low 32 bits if head has 8 argument bytes
+    byte type       = type_invalid; // type_t
+    byte ib         = 0;            // Initial byte
+
+    constexpr bool valid() const            { return type != type_invalid; }
+    constexpr bool indef() const            { return (ib & 0x1f) == ai_indef; }
+    constexpr uint64_t arg() const
+    {
+        return dec::heads[ib].len == 8 ? utl::load_be<uint64_t>(ptr - 8) : len;
+    }
+    constexpr uint64_t uint() const         { return arg(); }
+    constexpr int64_t sint() const          { return ~arg(); }
+    constexpr zbor::prim prim() const       { return zbor::prim(len); }
+    constexpr span data() const             { return {ptr, size_t(arg())}; }
+    constexpr dec::txt text() const         { return {ptr, size_t(arg())}; }
+    constexpr uint64_t size() const         { return indef() ? uint64_t(-1) : arg(); }  // Elements of array, pairs of map, uint64_t(-1) if indefinite
+    constexpr uint64_t num() const          { return arg(); }   // Tag number
+    constexpr double fp() const
+    {
+        switch (dec::heads[ib].len)
+        {
+        case 2: return std::bit_cast<float>(utl::half_to_float(len));
+        case 4: return std::bit_cast<float>(len);
+        default: return std::bit_cast<double>(arg());
+        }
+    }
+};
+
+/**
+ * @brief Decode head of item without touching its content.
+ *
+ * @param p Begin pointer, must be valid pointer
+ * @param end End pointer, must be valid pointer
+ * @return Decoded item, invalid if head is malformed, truncated or break
+ */
+constexpr item head(pointer p, const pointer end)
+{
+    if (p >= end)
+        return {};
+
+    byte ib = *p++;
+    auto& h = dec::heads[ib];
+
+    if (h.flags & (dec::head_break | dec::head_reserved | dec::head_bad_indef))
+        return {};
+    if (h.len > end - p)
+        return {};
+
+    uint64_t val = dec::arg(ib, h.len, p, end);
+    p += h.len;
+
+    if ((h.flags & dec::head_string) && val > uint64_t(end - p))
+        return {};
+    // Count reserved for indefinite length, see item::size()
+    if ((h.type == type_array || h.type == type_map) && val == uint64_t(-1))
+        return {};
+
+    return {p, uint32_t(val), h.type, ib};
+}
+
+/**
+ * @brief Skip item including its content. Strings and scalars are skipped
+ * directly by their head, without dec::skip().
+ *
+ * @param obj Item with valid head
+ * @param end End pointer, must be valid pointer
+ * @return Tuple with error status and pointer past item
+ */
+constexpr std::tuple<err, pointer> skip(const item& obj, const pointer end)
+{
+    auto& h = dec::heads[obj.ib];
+
+    if (h.flags & dec::head_string)
+        return {err_ok, obj.ptr + obj.arg()};
+    if (obj.type == type_indef_data || obj.type == type_indef_text)
+        return dec::skip_istr(type_t(obj.type), obj.ptr, end);
+    if (h.mul | h.add | (h.flags & dec::head_indef))
+        return dec::skip(obj.ptr - h.len - 1, end, 1, 0);
+    return {err_ok, obj.ptr};
+}
+
+/**
+ * @brief Sequence iterator over compact items, 24 bytes instead of 72 of
+ * zbor::seq_iter: only position of current item, end of input, number
+ * of items left and error packed with it. Items are decoded on dereference,
+ * and content of current item is skipped on increment. Stops at end of
+ * input, break or anything malformed.
+ *
+ */
+struct seq_iter {
+    constexpr seq_iter() = default;
+    constexpr seq_iter(pointer head, pointer tail, uint64_t cnt = uint64_t(-1)) :
+        at{head}, end{tail}, cnt{cnt == uint64_t(-1) ? indef : std::min(cnt, indef - 1)}
+    {
+        check(1);
+    }
+    constexpr bool operator!=(const seq_iter&) const
+    {
+        return cnt;
+    }
+    constexpr item operator*() const
+    {
+        return compact::head(at, end);
+    }
+    constexpr auto& operator++()
+    {
+        step(1);
+        return *this;
+    }
+    constexpr auto operator++(int)
+    {
+        auto tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+    constexpr pointer pos() const
+    {
+        return at;
+    }
+    /**
+     * @brief Error which stopped traversal before the end of sequence or
+     * container, same as zbor::seq_iter::error(). Indefinite container
+     * which runs to the end of input isn't reported, only its parent fails.
+     *
+     * @return Error status, err_ok if traversal ended normally or goes on
+     */
+    constexpr err error() const
+    {
+        return err(fail);
+    }
+protected:
+    // Count of indefinite container or sequence, counts of definite ones
+    // are limited to 56 bits, more elements than that can't fit into input
+    static constexpr uint64_t indef = (uint64_t(1) << 56) - 1;
+
+    // Skip n items including their content
+    constexpr void step(int n)
+    {
+        for (int i = 0; i < n && cnt; ++i) {
+            auto [e, p] = compact::skip(compact::head(at, end), end);
+            at = p;
+            if (e != err_ok)
+                stop(e);
+        }
+        if (cnt != indef)
+            cnt = cnt > uint64_t(n) ? cnt - n : 0;
+        check(n);
+    }
+    // Stop unless n following items have valid heads
+    constexpr void check(int n)
+    {
+        pointer p = at;
+        for (int i = 0; i < n && cnt; ++i) {
+            auto obj = compact::head(p, end);
+            if (!obj.valid()) {
+                // End of input or break ends indefinite one, unless value is missing
+                if (i || cnt != indef || (p < end && !(dec::heads[*p].flags & dec::head_break)))
+                    stop(std::get<err>(dec::skip(p, end, 1, 0)));
+                else
+                    stop(err_ok);
+            } else if (i + 1 < n) {
+                auto [e, next] = compact::skip(obj, end);
+                if (e != err_ok)
+                    stop(e);
+                p = next;
+            }
+        }
+    }
+    constexpr void stop(err e)
+    {
+        cnt = 0;
+        fail = e;
+    }
+
+    pointer at = nullptr;
+    pointer end = nullptr;
+    uint64_t cnt : 56 = 0;
+    uint64_t fail : 8 = err_ok;
+};
+
+/**
+ * @brief Map iterator over compact items, same size as compact::seq_iter.
+ * Value is located by skipping key on dereference, keys other than strings
+ * and numbers are skipped with their content.
+ *
+ */
+struct map_iter : seq_iter {
+    constexpr map_iter() = default;
+    constexpr map_iter(pointer head, pointer tail, uint64_t cnt = uint64_t(-1)) :
+        seq_iter{head, tail, cnt}
+    {
+        check(2);
+    }
+    constexpr auto operator*() const
+    {
+        auto key = compact::head(at, end);
+        return std::pair<item, item>{key, compact::head(std::get<pointer>(compact::skip(key, end)), end)};
+    }
+    constexpr auto& operator++()
+    {
+        step(2);
+        return *this;
+    }
+    constexpr auto operator++(int)
+    {
+        auto tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+};
+
+/**
+ * @brief Range of elements of container, see compact::seq.
+ *
+ * @tparam It Iterator type
+ */
+template<class It>
+struct range {
+    pointer head = nullptr;
+    pointer tail = nullptr;
+    uint64_t cnt = 0;
+    constexpr It begin() const  { return {head, tail, cnt}; }
+    constexpr It end() const    { return {}; }
+};
+
+/**
+ * @brief CBOR sequence traversed with compact items. Since items don't
+ * hold end of input, elements of nested containers are obtained through
+ * sequence they were decoded from, e.g. for (auto [k, v] : doc.map(rec)).
+ * Regular zbor::item of the same object is available with expand().
+ *
+ */
+struct seq : span {
+    using span::span;
+    constexpr seq(span s) : span{s} {}
+    constexpr seq_iter begin() const    { return {data(), tail()}; }
+    constexpr seq_iter end() const      { return {}; }
+
+    /**
+     * @brief Elements of array, or chunks of indefinite string.
+     *
+     * @param obj Array or indefinite string decoded from this sequence
+     * @return Range of items, empty if object is of other type
+     */
+    constexpr range<seq_iter> arr(const item& obj) const
+    {
+        if (obj.type == type_array)
+            return {obj.ptr, tail(), obj.size()};
+        if (obj.type == type_indef_data || obj.type == type_indef_text)
+            return {obj.ptr, tail(), uint64_t(-1)};
+        return {};
+    }
+
+    /**
+     * @brief Key-value pairs of map.
+     *
+     * @param obj Map decoded from this sequence
+     * @return Range of pairs, empty if object isn't map
+     */
+    constexpr range<map_iter> map(const item& obj) const
+    {
+        if (obj.type != type_map)
+            return {};
+        return {obj.ptr, tail(), obj.indef() ? uint64_t(-1) : std::min(obj.size(), uint64_t(-1) >> 2) << 1};
+    }
+
+    /**
+     * @brief Content of tag.
+     *
+     * @param obj Tag decoded from this sequence
+     * @return Tagged item, invalid if object isn't tag
+     */
+    constexpr item content(const item& obj) const
+    {
+        return obj.type == type_tag ? compact::head(obj.ptr, tail()) : item{};
+    }
+
+    /**
+     * @brief Regular item of the same object, decoded with decode_lazy().
+     *
+     * @param obj Item decoded from this sequence
+     * @return Regular item
+     */
+    constexpr zbor::item expand(const item& obj) const
+    {
+        if (!obj.valid())
+            return {};
+        return std::get<zbor::item>(decode_lazy(obj.ptr - dec::heads[obj.ib].len - 1, tail()));
+    }
+private:
+    constexpr pointer tail() const      { return data() + size(); }
+};
+
+static_assert(sizeof(item) <= 16);
+static_assert(sizeof(seq_iter) <= 24);
+static_assert(sizeof(map_iter) <= 24);
+
+}
+}
+
+#endif
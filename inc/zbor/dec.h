@@ -5,9 +5,15 @@
 #include <cstdint>
 #include <cstddef>
 #include <cstring>
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <span>
 #include <tuple>
 #include <string_view>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace zbor {
 
@@ -95,6 +101,24 @@ enum err {
     err_invalid_simple,
     err_invalid_indef_mt,
     err_invalid_indef_string,
+    err_invalid_type,
+    err_limit_exceeded,
+    err_trailing_bytes,
+    err_invalid_length,
+};
+
+/**
+ * @brief Limits of untrusted input, see zbor::validate() and zbor::decode(). 
+ * Exceeding any of them is reported as err_limit_exceeded.
+ * 
+ */
+struct limits {
+    static constexpr size_t max_depth = 256;
+
+    size_t depth    = 64;           // Nesting of arrays, maps, tags and indefinite strings, at most max_depth
+    uint64_t length = uint64_t(-1); // Elements of single array or pairs of single map
+    uint64_t string = uint64_t(-1); // Bytes of single string or chunk of indefinite string
+    uint64_t items  = uint64_t(-1); // Total number of items, including nested ones and string chunks
 };
 
 /**
@@ -140,24 +164,43 @@ struct txt : std::basic_string_view<byte> {
     }
 };
 
+struct chunk_range;
+
 /**
- * @brief Sequence wrapper for CBOR indefinite byte and text strings.
+ * @brief Sequence wrapper for CBOR indefinite byte and text strings. 
+ * Besides traversal of chunks as items, chunks() yields their payloads 
+ * directly as spans, and total_size() and copy_to() gather them.
  * 
  */
 struct istr : seq {
     using seq::seq;
+    constexpr chunk_range chunks() const;
+    constexpr size_t total_size() const;
+    constexpr std::tuple<size_t, err> copy_to(std::span<byte> out) const;
 };
 
 /**
- * @brief Sequence wrapper for CBOR array.
+ * @brief Sequence wrapper for CBOR array. If decoded lazily, range 
+ * spans from first element up to end of input, instead of exact tail, 
+ * and elements are also decoded lazily during traversal. Size of 
+ * indefinite array is size_t(-1), definite array with such count is 
+ * rejected by decoder with err_invalid_length.
  * 
  */
 struct arr : seq {
-    constexpr arr(pointer head, pointer tail, size_t len) : seq{head, tail}, len{len} {}
+    constexpr arr(pointer head, pointer tail, size_t len, bool lazy = false) : seq{head, tail}, len{len}, deferred{lazy} {}
     constexpr auto size() const     { return len; }
     constexpr bool indef() const    { return len == size_t(-1); } 
+    constexpr bool lazy() const     { return deferred; }
+    constexpr seq_iter begin() const;
+    constexpr seq_iter end() const;
+    constexpr item at(size_t i) const;
+    constexpr item operator[](size_t i) const;
+protected:
+    constexpr item nth(size_t i) const;
 private:
     size_t len;
+    bool deferred;
 };
 
 /**
@@ -168,6 +211,19 @@ struct map : arr {
     using arr::arr;
     constexpr map_iter begin() const;
     constexpr map_iter end() const;
+    constexpr item at(size_t i) const;
+    template<class Fn>
+    constexpr item find_if(Fn match) const;
+    constexpr item find(std::string_view key) const;
+    constexpr item find(uint64_t key) const;
+    constexpr item find(int64_t key) const;
+    constexpr item find(unsigned key) const;
+    constexpr item find(int key) const;
+    constexpr item operator[](std::string_view key) const;
+    constexpr item operator[](uint64_t key) const;
+    constexpr item operator[](int64_t key) const;
+    constexpr item operator[](unsigned key) const;
+    constexpr item operator[](int key) const;
 };
 
 /**
@@ -175,11 +231,13 @@ struct map : arr {
  * 
  */
 struct tag : seq {
-    constexpr tag(pointer head, pointer tail, uint64_t number) : seq{head, tail}, number{number} {}
-    constexpr uint64_t num() const { return number; }
+    constexpr tag(pointer head, pointer tail, uint64_t number, bool lazy = false) : seq{head, tail}, number{number}, deferred{lazy} {}
+    constexpr uint64_t num() const  { return number; }
+    constexpr bool lazy() const     { return deferred; }
     constexpr item content() const;
 private:
     uint64_t number;
+    bool deferred;
 };
 
 constexpr std::tuple<err, uint64_t, pointer> ai_check(byte ai, pointer p, const pointer end)
@@ -193,10 +251,15 @@ constexpr std::tuple<err, uint64_t, pointer> ai_check(byte ai, pointer p, const
         size_t len = utl::bit(ai - ai_1);
         if (p + len > end)
             return {err_out_of_bounds, 0, p};
-        uint64_t val = 0;
-        for (int i = 8 * len - 8; i >= 0; i -= 8)
-            val |= uint64_t(*p++) << i;
-        return {err_ok, val, p};
+        uint64_t val;
+        switch (ai) 
+        {
+        case ai_1: val = *p; break;
+        case ai_2: val = utl::load_be<uint16_t>(p); break;
+        case ai_4: val = utl::load_be<uint32_t>(p); break;
+        default:   val = utl::load_be<uint64_t>(p); break;
+        }
+        return {err_ok, val, p + len};
     }
     break;
     case 28:
@@ -206,6 +269,214 @@ constexpr std::tuple<err, uint64_t, pointer> ai_check(byte ai, pointer p, const
     return {err_ok, ai, p};
 }
 
+/**
+ * @brief Flags of initial byte, see dec::head_t.
+ * 
+ */
+enum head_flag : byte {
+    head_string     = 1 << 0,   // Definite string, argument is payload length
+    head_indef      = 1 << 1,   // Start of indefinite string or container
+    head_break      = 1 << 2,   // Break stop code
+    head_reserved   = 1 << 3,   // Reserved additional info
+    head_bad_indef  = 1 << 4,   // Indefinite length not allowed for major type
+    head_arg        = 1 << 5,   // Argument bytes follow initial byte
+    head_special    = head_indef | head_break | head_reserved | head_bad_indef,
+    head_slow       = head_special | head_arg,
+};
+
+/**
+ * @brief Properties of initial byte. Number of nested items to skip 
+ * after head is argument * mul + add. For heads with argument in 
+ * additional info, i.e. without head_arg, effect is precomputed as 
+ * size and items, so skipping them needs no further branches.
+ * 
+ */
+struct alignas(8) head_t {
+    byte type;  // Item type, type_t
+    byte len;   // Number of argument bytes after initial byte
+    byte flags; // Combination of head_flag
+    byte mul;   // Number of nested items per argument unit
+    byte add;   // Number of nested items regardless of argument
+    byte size;  // Payload bytes of string without head_arg
+    byte items; // Nested items of head without head_arg
+};
+
+/**
+ * @brief Generate lookup table for all 256 initial bytes.
+ * 
+ * @return Table indexed by initial byte
+ */
+constexpr std::array<head_t, 256> make_heads()
+{
+    std::array<head_t, 256> t{};
+
+    for (int i = 0; i < 256; ++i) {
+
+        byte mt = i & 0xe0;
+        byte ai = i & 0x1f;
+        auto& h = t[i];
+
+        h.type = mt >> 5;
+
+        if (ai >= ai_1 && ai <= ai_8) {
+            h.len   = utl::bit(ai - ai_1);
+            h.flags = head_arg;
+        }
+
+        if (ai > ai_8 && ai < ai_indef) {
+            h.flags = head_reserved;
+            continue;
+        }
+        switch (mt)
+        {
+        case mt_data:
+        case mt_text:
+            if (ai == ai_indef) {
+                h.type  = mt == mt_data ? type_indef_data : type_indef_text;
+                h.flags |= head_indef;
+            } else {
+                h.flags |= head_string;
+            }
+        break;
+        case mt_array:
+        case mt_map:
+            h.mul   = mt == mt_map ? 2 : 1;
+            h.flags |= ai == ai_indef ? head_indef : 0;
+        break;
+        case mt_tag:
+            h.add   = 1;
+            h.flags |= ai == ai_indef ? head_bad_indef : 0;
+        break;
+        case mt_simple:
+            if (ai == ai_indef)
+                h.flags |= head_break;
+            else if (ai >= prim_float_16)
+                h.type  = type_floating;
+        break;
+        default:
+            h.flags |= ai == ai_indef ? head_bad_indef : 0;
+        }
+        if (!(h.flags & head_slow)) {
+            if (h.flags & head_string)
+                h.size  = ai;
+            else
+                h.items = ai * h.mul + h.add;
+        }
+    }
+    return t;
+}
+
+inline constexpr auto heads = make_heads();
+
+/**
+ * @brief Read argument following initial byte. Bounds must be checked beforehand. 
+ * If at least 8 bytes remain, argument of any width is read by single load.
+ * 
+ * @param ib Initial byte
+ * @param len Number of argument bytes, see dec::head_t
+ * @param p Pointer past initial byte
+ * @param end End pointer
+ * @return Argument value
+ */
+constexpr uint64_t arg(byte ib, byte len, pointer p, const pointer end)
+{
+    if (len && end - p >= 8)
+        return utl::load_be<uint64_t>(p) >> (64 - 8 * len);
+
+    switch (len)
+    {
+    case 0: return ib & 0x1f;
+    case 1: return *p;
+    case 2: return utl::load_be<uint16_t>(p);
+    case 4: return utl::load_be<uint32_t>(p);
+    default: return utl::load_be<uint64_t>(p);
+    }
+}
+
+
+/**
+ * @brief Classify 8 bytes at once (SWAR), see dec::scalars(). Only bit 7 of each 
+ * byte is meaningful in result: set if byte isn't single-byte scalar head, i.e. 
+ * not in 0x00-0x17, 0x20-0x37 or 0xe0-0xf7. Same expression is used for vectors.
+ * 
+ * @param c Eight bytes of input
+ * @return Mask of non-scalar bytes
+ */
+constexpr uint64_t non_scalars(uint64_t c)
+{
+    constexpr uint64_t ai  = 0x1f1f1f1f1f1f1f1f;
+    constexpr uint64_t off = 0x0808080808080808;
+    constexpr uint64_t msb = 0x8080808080808080;
+
+    // Major type 0, 1 or 7: bit 7 equals bit 6, and bit 5 is set if bit 7 is. 
+    // Additional info < 24: adding 8 doesn't carry into bit 5.
+    return ((c ^ (c << 1)) | (c & ~(c << 2)) | (((c & ai) + off) << 2)) & msb;
+}
+
+/**
+ * @brief Count leading run of single-byte scalar heads: small integers 
+ * (0x00-0x17, 0x20-0x37) and simple values (0xe0-0xf7), e.g. content of 
+ * sensor arrays and bitmaps. Classifies 32 (AVX2), 16 (SSE) or 8 bytes 
+ * per step, whichever is available.
+ * 
+ * @param p Begin pointer, must be valid pointer
+ * @param end End pointer, must be valid pointer
+ * @return Number of leading single-byte scalar items
+ */
+constexpr size_t scalars(pointer p, const pointer end)
+{
+    auto begin = p;
+
+    if (!std::is_constant_evaluated()) {
+        // Most runs are short, check first 8 bytes before vector loop
+        auto swar = [&]() -> size_t {
+            uint64_t c;
+            memcpy(&c, p, 8);
+            auto m = non_scalars(c);
+            return (std::endian::native == std::endian::little ? 
+                std::countr_zero(m) : std::countl_zero(m)) / 8;
+        };
+        if (end - p >= 8) {
+            if (auto n = swar(); n < 8)
+                return n;
+            p += 8;
+        }
+#if defined(__AVX2__)
+        const auto ai  = _mm256_set1_epi8(0x1f);
+        const auto off = _mm256_set1_epi8(0x08);
+        for (; end - p >= 32; p += 32) {
+            auto c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            auto x = _mm256_or_si256(
+                _mm256_or_si256(
+                    _mm256_xor_si256(c, _mm256_slli_epi16(c, 1)), 
+                    _mm256_andnot_si256(_mm256_slli_epi16(c, 2), c)),
+                _mm256_slli_epi16(_mm256_add_epi8(_mm256_and_si256(c, ai), off), 2));
+            if (auto m = uint32_t(_mm256_movemask_epi8(x)))
+                return p - begin + std::countr_zero(m);
+        }
+#elif defined(__SSE2__)
+        const auto ai  = _mm_set1_epi8(0x1f);
+        const auto off = _mm_set1_epi8(0x08);
+        for (; end - p >= 16; p += 16) {
+            auto c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            auto x = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_xor_si128(c, _mm_slli_epi16(c, 1)), 
+                    _mm_andnot_si128(_mm_slli_epi16(c, 2), c)),
+                _mm_slli_epi16(_mm_add_epi8(_mm_and_si128(c, ai), off), 2));
+            if (auto m = uint32_t(_mm_movemask_epi8(x)))
+                return p - begin + std::countr_zero(m);
+        }
+#endif
+        for (; end - p >= 8; p += 8) {
+            if (auto n = swar(); n < 8)
+                return p - begin + n;
+        }
+    }
+    for (; p < end && !(non_scalars(*p) & 0x80); ++p);
+
+    return p - begin;
+}
 }
 
 /**
@@ -219,7 +490,7 @@ struct item {
     union {
         uint64_t uint;
         int64_t sint;
-        prim prim;
+        zbor::prim prim;
         span data;
         dec::txt text;
         dec::istr istr;
@@ -230,198 +501,503 @@ struct item {
     };
 };
 
+namespace dec {
+
 /**
- * @brief Decode next adjacent CBOR item. Almost all validity checks always performed 
- * throughout decoding process: out-of-bounds, reserved AI, invalid indef MT, nested 
- * indefinite strings, break without start. What isn't checked is number of elements 
- * within nested containers (if at least one of them is indefinite). For example, 0x9f82ff 
- * will be first parsed as valid indefinite array, and then, only if user starts to traverse 
- * over its elements, decoding of malformed nested array will report err_out_of_bounds.
+ * @brief Skip given number of adjacent items, including all their nested 
+ * content, and remaining elements of open indefinite containers.
  * 
  * @param p Begin pointer, must be valid pointer
  * @param end End pointer, must be valid pointer
+ * @param skip Number of items to skip
+ * @param nest Number of open indefinite containers, each closed by break
+ * @return Tuple with error status and pointer past last character interpreted
+ */
+constexpr std::tuple<err, pointer> skip(pointer p, const pointer end, uint64_t skip, size_t nest)
+{
+    uint64_t val;
+    bool bulk = false; // Large container started or long run of scalars seen
+
+    while (skip || nest) {
+
+        if (p >= end)
+            return {err_out_of_bounds, end};
+
+        byte ib = *p++;
+        auto& h = heads[ib];
+
+        if (!(h.flags & head_slow)) {
+            if (h.size > end - p)
+                return {err_out_of_bounds, p};
+            p += h.size;
+            if (!nest)
+                skip += h.items;
+            if (bulk & !(h.size | h.items)) [[unlikely]] {
+                uint64_t n = scalars(p, end);
+                bulk = n >= 8;
+                if (!nest) {
+                    n = std::min(n, skip - 1);
+                    skip -= n;
+                }
+                p += n;
+            } else {
+                bulk = h.items >= 16;
+            }
+        } else if (h.flags & head_arg) {
+            if (h.len > end - p)
+                return {err_out_of_bounds, p};
+
+            val = arg(ib, h.len, p, end);
+            p += h.len;
+
+            if (h.flags & head_string) {
+                if (val > uint64_t(end - p))
+                    return {err_out_of_bounds, p};
+                p += val;
+            } else {
+                // Every element takes at least one byte, so huge count can't 
+                // overflow counter and is rejected right away, as if skipped up to end
+                if (h.mul && val > uint64_t(end - p))
+                    return {err_out_of_bounds, end};
+                if (!nest)
+                    skip += val * h.mul + h.add;
+                bulk = val * h.mul >= 16;
+            }
+        } else {
+            switch (h.flags)
+            {
+            case head_indef: 
+                ++nest; 
+                bulk = true;
+            break;
+            case head_break:
+                if (!nest)
+                    return {err_invalid_break, p};
+                --nest;
+            break;
+            case head_reserved: return {err_reserved_ai, p};
+            default: return {err_invalid_indef_mt, p};
+            }
+        }
+        if (skip && !nest)
+            skip--;
+    }
+    return {err_ok, p};
+}
+
+/**
+ * @brief Skip chunks of indefinite byte or text string up to and including 
+ * break. Every chunk must be definite string of the same major type.
+ * 
+ * @param type Either type_indef_data or type_indef_text
+ * @param p Pointer to first chunk, must be valid pointer
+ * @param end End pointer, must be valid pointer
+ * @return Tuple with error status and pointer past last character interpreted
+ */
+constexpr std::tuple<err, pointer> skip_istr(type_t type, pointer p, const pointer end)
+{
+    uint64_t val;
+    err e;
+
+    while (true) {
+        
+        if (p >= end)
+            return {err_out_of_bounds, end};
+
+        if (*p == 0xff)
+            return {err_ok, p + 1};
+
+        val = *p & 0x1f;
+
+        if (type != ((*p++ & 0xe0) >> 5) + 7 || val == ai_indef)
+            return {err_invalid_indef_string, p};
+
+        std::tie(e, val, p) = ai_check(val, p, end);
+
+        if (e != err_ok)
+            return {e, p};
+
+        if (val > uint64_t(end - p))
+            return {err_out_of_bounds, p};
+
+        p += val;
+    }
+}
+
+/**
+ * @brief Skip remaining items of container like dec::skip(), but with all 
+ * well-formedness checks and limits, see zbor::validate(). Keeps counter of 
+ * remaining items per open nested container on fixed stack.
+ * 
+ * @param p Pointer to next item of container, must be valid pointer
+ * @param end End pointer, must be valid pointer
+ * @param left Items left in container, top bit set if it's indefinite
+ * @param type Type of container, type_array for sequence of left items
+ * @param depth Number of nested containers which may be opened, at most limits::max_depth
+ * @param items Number of items which may be skipped
+ * @param lim Limits of length of containers and strings
+ * @return Tuple with error status and pointer past container, or to offending 
+ * item if error occurred
+ */
+constexpr std::tuple<err, pointer> check(pointer p, const pointer end, uint64_t left, byte type, 
+    size_t depth, uint64_t items, const limits& lim)
+{
+    constexpr uint64_t indef = uint64_t(1) << 63;
+
+    struct {
+        uint64_t left;
+        byte type;
+    } stack[limits::max_depth];
+
+    // Heads with argument in additional info can't exceed usual limits
+    const bool small    = lim.length >= ai_0 && lim.string >= ai_0;
+    size_t lvl          = 0;
+    bool bulk           = false;    // Large container started or long run of scalars seen
+    pointer at;
+    uint64_t val;
+
+    // Enter container, unless it's empty
+    auto open = [&](uint64_t n, byte t) -> bool {
+        if (lvl == depth)
+            return false;
+        stack[lvl++] = {left, type};
+        left = n;
+        type = t;
+        return true;
+    };
+
+    while (true) {
+
+        if (p >= end)
+            return {err_out_of_bounds, end};
+
+        at = p;
+        byte ib = *p++;
+        auto& h = heads[ib];
+
+        if (type >= type_indef_data) [[unlikely]] {
+            if (ib != 0xff && (type != h.type + 7 || !(h.flags & head_string)))
+                return {err_invalid_indef_string, at};
+        }
+        if (ib != 0xff && !items--)
+            return {err_limit_exceeded, at};
+
+        if (!(h.flags & head_slow)) {
+            if (!small && (h.size > lim.string || (h.mul && (ib & 0x1f) > lim.length))) [[unlikely]]
+                return {err_limit_exceeded, at};
+            if (h.size > end - p)
+                return {err_out_of_bounds, at};
+            p += h.size;
+            if (h.items) {
+                if (!open(h.items, h.type))
+                    return {err_limit_exceeded, at};
+                bulk = h.items >= 16;
+                continue;
+            }
+            if (bulk & !h.size & (type < type_indef_data)) [[unlikely]] {
+                // Run of single-byte scalars, which never exceeds current container
+                uint64_t n = scalars(p, end);
+                bulk = n >= 8;
+                if (!(left & indef))
+                    n = std::min(n, left - 1);
+                if (n > items)
+                    return {err_limit_exceeded, p + items};
+                items -= n;
+                left -= n;
+                p += n;
+            }
+        } else if (h.flags & head_arg) {
+            if (h.len > end - p)
+                return {err_out_of_bounds, at};
+
+            val = arg(ib, h.len, p, end);
+            p += h.len;
+
+            if (h.flags & head_string) {
+                if (val > lim.string)
+                    return {err_limit_exceeded, at};
+                if (val > uint64_t(end - p))
+                    return {err_out_of_bounds, at};
+                p += val;
+            } else if (h.mul | h.add) {
+                if (h.mul && val > lim.length)
+                    return {err_limit_exceeded, at};
+                // Every element takes at least one byte
+                if (h.mul && val > uint64_t(end - p))
+                    return {err_out_of_bounds, at};
+                if (uint64_t n = val * h.mul + h.add) {
+                    if (!open(n, h.type))
+                        return {err_limit_exceeded, at};
+                    bulk = n >= 16;
+                    continue;
+                }
+            } else if (ib == 0xf8 && val < 32) {
+                return {err_invalid_simple, at};
+            }
+        } else {
+            switch (h.flags)
+            {
+            case head_indef:
+                if (!open(indef | (indef - 1), h.type))
+                    return {err_limit_exceeded, at};
+                bulk = true;
+            continue;
+            case head_break:
+                // Counter of indefinite map is odd after even number of items
+                if (!(left & indef) || (type == type_map && !(left & 1)))
+                    return {err_invalid_break, at};
+                if (!lvl)
+                    return {err_ok, p};
+                left = stack[--lvl].left;
+                type = stack[lvl].type;
+            break;
+            case head_reserved: return {err_reserved_ai, at};
+            default: return {err_invalid_indef_mt, at};
+            }
+        }
+        // Count completed item in enclosing containers, close exhausted ones
+        while (!--left) {
+            if (!lvl)
+                return {err_ok, p};
+            left = stack[--lvl].left;
+            type = stack[lvl].type;
+        }
+    }
+}
+
+/**
+ * @brief Decode next adjacent CBOR item, see zbor::decode() and zbor::decode_lazy().
+ * 
+ * @param p Begin pointer, must be valid pointer
+ * @param end End pointer, must be valid pointer
+ * @param lazy Don't skip content of containers, tags and indefinite strings
+ * @param lim Limits, if given content is skipped with dec::check() instead of dec::skip()
  * @return Tuple with decoded object, error status and pointer past last character interpreted
  */
-constexpr std::tuple<item, err, pointer> decode(pointer p, const pointer end)
+constexpr std::tuple<item, err, pointer> decode(pointer p, const pointer end, bool lazy, const limits* lim = nullptr)
 {
     if (p >= end)
         return {{}, err_out_of_bounds, end};
 
-    byte mt             = *p   & 0xe0;
-    byte ai             = *p++ & 0x1f;
-    item obj            = type_t(mt >> 5);
-    uint64_t val        = ai;
+    byte ib             = *p++;
+    auto& h             = heads[ib];
+    item obj            = type_t(h.type);
+    uint64_t val        = 0;
     uint64_t size       = 0;
     size_t nest         = 0;
     size_t skip         = 0;
     decltype(p) head    = nullptr;
+    decltype(p) tail    = end;
     err e;
 
-    if (ai == ai_indef) {
-        switch (mt)
+    if (h.flags & head_special) {
+        switch (h.flags)
         {
-        case mt_data: obj.type = type_indef_data; break;
-        case mt_text: obj.type = type_indef_text; break;
-        case mt_array:
-        case mt_map: size = size_t(-1); break;
-        case mt_simple: return {{}, err_invalid_break, p};
+        case head_indef: break;
+        case head_break: return {{}, err_invalid_break, p};
+        case head_reserved: return {{}, err_reserved_ai, p};
         default: return {{}, err_invalid_indef_mt, p};
         }
+        size = size_t(-1);
         head = p;
         nest = 1;
     } else {
-        std::tie(e, val, p) = dec::ai_check(ai, p, end);
+        if (h.len > end - p)
+            return {{}, err_out_of_bounds, p};
 
-        if (e != err_ok)
-            return {{}, e, p};
+        val = arg(ib, h.len, p, end);
+        p += h.len;
 
-        switch (mt) 
+        switch (h.type) 
         {
-        case mt_uint: obj.uint = val; break;
-        case mt_nint: obj.sint = ~val; break;
-        case mt_data:
-            if (p + val > end)
+        case type_uint: obj.uint = val; break;
+        case type_sint: obj.sint = ~val; break;
+        case type_data:
+            if (val > uint64_t(end - p))
                 return {{}, err_out_of_bounds, p};
             obj.data = {p, size_t(val)};
             p += val;
         break;
-        case mt_text:
-            if (p + val > end)
+        case type_text:
+            if (val > uint64_t(end - p))
                 return {{}, err_out_of_bounds, p};
             obj.text = {p, size_t(val)};
             p += val;
         break;
-        case mt_map:
-            head = p;
-            size = val;
-            skip = val << 1;
-        break;
-        case mt_array:
+        case type_array:
+        case type_map:
+            // Count reserved for indefinite length, see dec::arr::indef()
+            if (val >= size_t(-1))
+                return {{}, err_invalid_length, p};
+            [[fallthrough]];
+        case type_tag:
             head = p;
             size = val;
-            skip = val;
+            skip = val * h.mul + h.add;
         break;
-        case mt_tag:
-            head = p;
-            size = val;
-            skip = 1;
-        break;
-        case mt_simple:
-            switch (ai) 
+        case type_floating:
+            switch (h.len) 
             {
-            case prim_float_16:
-                obj.fp      = std::bit_cast<float>(utl::half_to_float(val));
-                obj.type    = type_floating;
-            break;
-            case prim_float_32:
-                obj.fp      = std::bit_cast<float>(uint32_t(val));
-                obj.type    = type_floating;
-            break;
-            case prim_float_64:
-                obj.fp      = std::bit_cast<double>(val);
-                obj.type    = type_floating;
-            break;
-            default:
-                obj.prim    = prim(val);
-            break;
+            case 2: obj.fp = std::bit_cast<float>(utl::half_to_float(val)); break;
+            case 4: obj.fp = std::bit_cast<float>(uint32_t(val)); break;
+            default: obj.fp = std::bit_cast<double>(val); break;
             }
         break;
+        default:
+            obj.prim = prim(val);
+        break;
         }
     }
 
-    if (obj.type == type_indef_data || 
-        obj.type == type_indef_text) 
-    {
-        while (true) {
-            
-            if (p >= end)
-                return {{}, err_out_of_bounds, end};
-
-            if (*p == 0xff) {
-                ++p;
-                break;
-            }
-            val = *p & 0x1f;
-
-            if (obj.type != ((*p++ & 0xe0) >> 5) + 7 || val == ai_indef)
-                return {{}, err_invalid_indef_string, p};
+    if (lim) {
+        if (!lim->items || ((skip || nest) && !lim->depth) ||
+            ((obj.type == type_data || obj.type == type_text) && val > lim->string) ||
+            ((obj.type == type_array || obj.type == type_map) && !nest && val > lim->length))
+            return {{}, err_limit_exceeded, p};
+    }
+    // Every element takes at least one byte, so huge count is rejected right 
+    // away, as if it was skipped up to end
+    if (!lazy && h.mul && !nest && val > uint64_t(end - p))
+        return {{}, err_out_of_bounds, end};
 
-            std::tie(e, val, p) = dec::ai_check(val, p, end);
+    if (!lazy) {
+        if (lim) {
+            if (skip || nest)
+                std::tie(e, p) = check(p, end, nest ? uint64_t(-1) : skip, obj.type,
+                    std::min(lim->depth, limits::max_depth) - 1, lim->items - 1, *lim);
+            else
+                e = err_ok;
+        } else if (obj.type == type_indef_data || 
+            obj.type == type_indef_text)
+            std::tie(e, p) = skip_istr(obj.type, p, end);
+        else
+            std::tie(e, p) = dec::skip(p, end, skip, nest);
 
-            if (e != err_ok)
-                return {{}, e, p};
+        if (e != err_ok)
+            return {{}, e, p};
 
-            p += val;
-        }
-    } else {
-        while (skip || nest) {
-
-            if (p >= end)
-                return {{}, err_out_of_bounds, end};
-
-            mt  = *p   & 0xe0;
-            val = *p++ & 0x1f;
-
-            if (val == ai_indef) {
-                switch (mt) {
-                case mt_data:
-                case mt_text:
-                case mt_array:
-                case mt_map: ++nest; 
-                break;
-                case mt_simple:
-                    if (!nest)
-                        return {{}, err_invalid_break, p};
-                    --nest;
-                break;
-                default: return {{}, err_invalid_indef_mt, p};
-                }
-            } else {
-                std::tie(e, val, p) = dec::ai_check(val, p, end);
-
-                if (e != err_ok) 
-                    return {{}, e, p};
-                    
-                switch (mt) {
-                case mt_data:
-                case mt_text:   
-                    if (p + val > end)
-                        return {{}, err_out_of_bounds, p};
-                    p += val; 
-                break;
-                case mt_array:  if (!nest) skip += val;         break;
-                case mt_map:    if (!nest) skip += val << 1;    break;
-                case mt_tag:    if (!nest) skip += 1;           break;
-                }
-            }
-            if (skip && !nest)
-                skip--;
-        }
+        tail = p;
     }
     switch (obj.type) 
     {
-    case type_array:        obj.arr  = {head, p, size}; break;
-    case type_map:          obj.map  = {head, p, size}; break;
-    case type_tag:          obj.tag  = {head, p, size}; break;
-    case type_indef_data:   obj.istr = {head, p}; break;
-    case type_indef_text:   obj.istr = {head, p}; break;
+    case type_array:        obj.arr  = {head, tail, size, lazy}; break;
+    case type_map:          obj.map  = {head, tail, size, lazy}; break;
+    case type_tag:          obj.tag  = {head, tail, size, lazy}; break;
+    case type_indef_data:   obj.istr = {head, tail}; break;
+    case type_indef_text:   obj.istr = {head, tail}; break;
     default:;
     }
     return {obj, err_ok, p};
 }
 
+}
+
+/**
+ * @brief Decode next adjacent CBOR item. Almost all validity checks always performed 
+ * throughout decoding process: out-of-bounds, reserved AI, invalid indef MT, nested 
+ * indefinite strings, break without start. What isn't checked is number of elements 
+ * within nested containers (if at least one of them is indefinite). For example, 0x9f82ff 
+ * will be first parsed as valid indefinite array, and then, only if user starts to traverse 
+ * over its elements, decoding of malformed nested array will report err_out_of_bounds.
+ * 
+ * @param p Begin pointer, must be valid pointer
+ * @param end End pointer, must be valid pointer
+ * @return Tuple with decoded object, error status and pointer past last character interpreted
+ */
+constexpr std::tuple<item, err, pointer> decode(pointer p, const pointer end)
+{
+    return dec::decode(p, end, false);
+}
+
+/**
+ * @brief Decode next adjacent CBOR item from untrusted input, which is rejected 
+ * with err_limit_exceeded in bounded time if it exceeds limits. Content is 
+ * skipped with the same checks as zbor::validate(), so unlike plain decode() 
+ * it also checks number of elements of containers nested in indefinite ones.
+ * 
+ * @param p Begin pointer, must be valid pointer
+ * @param end End pointer, must be valid pointer
+ * @param lim Limits
+ * @return Tuple with decoded object, error status and pointer past last character 
+ * interpreted (or to offending nested item)
+ */
+constexpr std::tuple<item, err, pointer> decode(pointer p, const pointer end, const limits& lim)
+{
+    return dec::decode(p, end, false, &lim);
+}
+
+/**
+ * @brief Decode next adjacent CBOR item, but only its head in case of arrays, maps, 
+ * tags and indefinite strings. Their content isn't skipped nor validated, instead range 
+ * of such item spans from first nested byte up to end, and exact tail is discovered 
+ * by iterator during traversal, so each byte is touched only once. Returned pointer 
+ * is past the head, i.e. points to first nested item.
+ * 
+ * @param p Begin pointer, must be valid pointer
+ * @param end End pointer, must be valid pointer
+ * @return Tuple with decoded object, error status and pointer past last character interpreted
+ */
+constexpr std::tuple<item, err, pointer> decode_lazy(pointer p, const pointer end)
+{
+    return dec::decode(p, end, true);
+}
+
+/**
+ * @brief Decode head of next adjacent CBOR item like decode_lazy(), checking 
+ * its length and nesting against limits. Limits don't apply to later traversal 
+ * of content, run zbor::validate() first if that's required.
+ * 
+ * @param p Begin pointer, must be valid pointer
+ * @param end End pointer, must be valid pointer
+ * @param lim Limits
+ * @return Tuple with decoded object, error status and pointer past last character interpreted
+ */
+constexpr std::tuple<item, err, pointer> decode_lazy(pointer p, const pointer end, const limits& lim)
+{
+    return dec::decode(p, end, true, &lim);
+}
+
+/**
+ * @brief Check that input is exactly one well-formed CBOR item, without 
+ * decoding it, e.g. before handing untrusted message to handlers. Single 
+ * pass over input with dec::check(), which uses head table of dec::skip() 
+ * and keeps only counter of remaining items per open container. Unlike 
+ * decode(), it also checks number of elements of containers nested in 
+ * indefinite ones, even number of items in indefinite maps and two-byte 
+ * simple values below 32.
+ * 
+ * @param buf Input
+ * @param lim Limits
+ * @return Tuple with error status and offset of offending item (or of first 
+ * trailing byte), size of input if valid
+ */
+constexpr std::tuple<err, size_t> validate(span buf, const limits& lim = {})
+{
+    const pointer begin = buf.data();
+    const pointer end   = begin + buf.size();
+
+    auto [e, p] = dec::check(begin, end, 1, type_array, std::min(lim.depth, limits::max_depth), lim.items, lim);
+
+    if (e == err_ok && p != end)
+        e = err_trailing_bytes;
+    return {e, size_t(p - begin)};
+}
+
 /**
  * @brief Sequence iterator which holds range (begin and end pointers). Used 
  * to traverse CBOR sequence (RFC-8742), which is just series of adjacent 
  * objects. Used to traverse arr_t, istr_t or any series of bytes as item 
- * one by one. Only exception is map_t.
+ * one by one. Only exception is map_t. Optionally limited by number of items 
+ * and in lazy mode decodes items with decode_lazy(), skipping content of 
+ * previous one only if it wasn't traversed and passed to resume().
  * 
  */
 struct seq_iter {
     constexpr seq_iter() = default;
-    constexpr seq_iter(pointer head, pointer tail) : head{head}, tail{tail}
+    constexpr seq_iter(pointer head, pointer tail, size_t cnt = size_t(-1), bool lazy = false) : 
+        head{head}, tail{tail}, cnt{cnt}, lazy{lazy}
     {
-        step(key);
+        step(key, key);
     }
     constexpr bool operator!=(const seq_iter&) const 
     { 
@@ -433,7 +1009,7 @@ struct seq_iter {
     }
     constexpr auto& operator++()
     {
-        step(key);
+        step(key, key);
         return *this;
     }
     constexpr auto operator++(int) 
@@ -442,14 +1018,88 @@ struct seq_iter {
         ++(*this); 
         return tmp; 
     }
+    constexpr pointer pos() const
+    {
+        return head;
+    }
+    /**
+     * @brief Error which stopped traversal before the end of sequence or 
+     * container, e.g. truncated or malformed element.
+     * 
+     * @return Error status, err_ok if traversal ended normally or goes on
+     */
+    constexpr err error() const
+    {
+        return fail;
+    }
+    constexpr auto& resume(pointer p)
+    {
+        head = p;
+        pend = false;
+        return *this;
+    }
 protected:
-    constexpr void step(item& o) 
+    constexpr void step(item& o, item& prev) 
     {
-        std::tie(o, std::ignore, head) = decode(head, tail); 
+        if (pend)
+            resolve(prev);
+        // End of input ends sequence, while lazy container must end with break
+        if (!cnt || (cnt == size_t(-1) && !lazy && head >= tail)) {
+            o = {};
+            return;
+        }
+        err e;
+        std::tie(o, e, head) = dec::decode(head, tail, lazy);
+
+        if (e != err_ok && !(cnt == size_t(-1) && e == err_invalid_break))
+            fail = e;
+        if (cnt != size_t(-1))
+            --cnt;
+
+        pend = lazy && (
+            o.type == type_array ||
+            o.type == type_map ||
+            o.type == type_tag ||
+            o.type == type_indef_data ||
+            o.type == type_indef_text);
+    }
+    constexpr void resolve(item& o)
+    {
+        err e;
+        pointer p;
+
+        switch (o.type) 
+        {
+        case type_array:
+            std::tie(e, p) = dec::skip(head, tail, o.arr.indef() ? 0 : o.arr.size(), o.arr.indef());
+            o.arr = {o.arr.data(), p, o.arr.size(), true};
+        break;
+        case type_map:
+            std::tie(e, p) = dec::skip(head, tail, o.map.indef() ? 0 : o.map.size() << 1, o.map.indef());
+            o.map = {o.map.data(), p, o.map.size(), true};
+        break;
+        case type_tag:
+            std::tie(e, p) = dec::skip(head, tail, 1, 0);
+            o.tag = {o.tag.data(), p, o.tag.num(), true};
+        break;
+        default:
+            std::tie(e, p) = dec::skip_istr(o.type, head, tail);
+            o.istr = {o.istr.data(), p};
+        }
+        if (e != err_ok) {
+            cnt = 0;
+            fail = e;
+        }
+        head = p;
+        pend = false;
     }
 protected:
     pointer head = nullptr;
     pointer tail = nullptr;
+    size_t cnt = 0;
+    bool lazy = false;
+    bool pend = false;
+    err fail = err_ok;
     item key;
 };
 
@@ -460,10 +1110,11 @@ protected:
  */
 struct map_iter : seq_iter {
     constexpr map_iter() = default;
-    constexpr map_iter(pointer head, pointer tail) : seq_iter{head, tail}
+    constexpr map_iter(pointer head, pointer tail, size_t cnt = size_t(-1), bool lazy = false) : 
+        seq_iter{head, tail, cnt, lazy}
     {
         if (key.valid()) 
-            step(val);
+            pair();
     }
     constexpr bool operator!=(const map_iter&) const 
     { 
@@ -475,9 +1126,9 @@ struct map_iter : seq_iter {
     }
     constexpr auto& operator++()
     {
-        step(key);
+        step(key, val);
         if (key.valid()) 
-            step(val);
+            pair();
         return *this;
     }
     constexpr auto operator++(int) 
@@ -487,14 +1138,234 @@ struct map_iter : seq_iter {
         return tmp; 
     }
 private:
+    constexpr void pair()
+    {
+        step(val, key);
+        // Break instead of value
+        if (!val.valid() && fail == err_ok)
+            fail = err_invalid_break;
+    }
+
     item val;
 };
 
 constexpr seq_iter seq::begin() const       { return {data(), data() + size()}; }
 constexpr seq_iter seq::end() const         { return {}; }
-constexpr map_iter dec::map::begin() const  { return {data(), data() + seq::size()}; }
+constexpr seq_iter dec::arr::begin() const  { return {data(), data() + seq::size(), len, deferred}; }
+constexpr seq_iter dec::arr::end() const    { return {}; }
+constexpr map_iter dec::map::begin() const  { return {data(), data() + seq::size(), indef() ? size_t(-1) : size() << 1, lazy()}; }
 constexpr map_iter dec::map::end() const    { return {}; }
-constexpr item dec::tag::content() const    { return std::get<item>(decode(data(), data() + size())); }
+constexpr item dec::tag::content() const    { return std::get<item>(dec::decode(data(), data() + size(), deferred)); }
+
+namespace dec {
+
+/**
+ * @brief Iterator over chunks of indefinite string, which yields payload 
+ * of every chunk as span read directly from its head, without decoding 
+ * item. Stops at break or anything which isn't definite string of the 
+ * same major type as the first chunk.
+ * 
+ */
+struct chunk_iter {
+    constexpr chunk_iter() = default;
+    constexpr chunk_iter(pointer head, pointer tail) : head{head}, tail{tail}
+    {
+        step();
+    }
+    constexpr bool operator!=(const chunk_iter&) const 
+    { 
+        return valid;
+    }
+    constexpr span operator*() const 
+    { 
+        return chunk; 
+    }
+    constexpr auto& operator++()
+    {
+        step();
+        return *this;
+    }
+    constexpr auto operator++(int) 
+    { 
+        auto tmp = *this; 
+        ++(*this); 
+        return tmp; 
+    }
+    constexpr pointer pos() const
+    {
+        return head;
+    }
+private:
+    constexpr void step()
+    {
+        valid = false;
+
+        if (head >= tail)
+            return;
+
+        byte ib = *head;
+        auto& h = heads[ib];
+
+        if (!(h.flags & head_string) || (mt && (ib & 0xe0) != mt) || h.len >= tail - head)
+            return;
+
+        pointer p = head + 1;
+        uint64_t len = dec::arg(ib, h.len, p, tail);
+        p += h.len;
+
+        if (len > uint64_t(tail - p))
+            return;
+
+        chunk = {p, size_t(len)};
+        head = p + len;
+        mt = ib & 0xe0;
+        valid = true;
+    }
+
+    pointer head = nullptr;
+    pointer tail = nullptr;
+    span chunk;
+    byte mt = 0;
+    bool valid = false;
+};
+
+/**
+ * @brief Range of chunks of indefinite string, see dec::istr::chunks().
+ * 
+ */
+struct chunk_range : span {
+    using span::span;
+    constexpr chunk_iter begin() const  { return {data(), data() + size()}; }
+    constexpr chunk_iter end() const    { return {}; }
+};
+
+}
+
+constexpr dec::chunk_range dec::istr::chunks() const { return {data(), size()}; }
+
+/**
+ * @brief Total length of indefinite string, sum of sizes of its chunks.
+ * 
+ * @return Number of bytes
+ */
+constexpr size_t dec::istr::total_size() const
+{
+    size_t n = 0;
+    for (auto c : chunks())
+        n += c.size();
+    return n;
+}
+
+/**
+ * @brief Concatenate chunks of indefinite string in a single pass.
+ * 
+ * @param out Output bytes
+ * @return Total length of string and error status, err_no_memory if output 
+ * is shorter, in which case it holds only the beginning of string
+ */
+constexpr std::tuple<size_t, err> dec::istr::copy_to(std::span<byte> out) const
+{
+    size_t n = 0;
+    for (auto c : chunks()) {
+        if (n < out.size())
+            std::copy_n(c.data(), std::min(c.size(), out.size() - n), out.data() + n);
+        n += c.size();
+    }
+    return {n, n > out.size() ? err_no_memory : err_ok};
+}
+
+/**
+ * @brief Get element by index. Preceding elements are skipped without being 
+ * decoded, which is still O(i), see zbor::arr_index for O(1) access.
+ * 
+ * @param i Element index
+ * @return Decoded element, or invalid item if out of range or malformed
+ */
+constexpr item dec::arr::at(size_t i) const
+{
+    return !indef() && i >= len ? item{} : nth(i);
+}
+
+constexpr item dec::arr::operator[](size_t i) const { return at(i); }
+
+constexpr item dec::arr::nth(size_t i) const
+{
+    auto end = data() + seq::size();
+    auto [e, p] = dec::skip(data(), end, i, 0);
+
+    if (e != err_ok)
+        return {};
+
+    return std::get<item>(dec::decode(p, end, deferred));
+}
+
+/**
+ * @brief Get key or value by index, see dec::arr::at().
+ * 
+ * @param i Index with keys and values counted separately, key of pair n is 2n and value 2n + 1
+ * @return Decoded key or value, or invalid item if out of range or malformed
+ */
+constexpr item dec::map::at(size_t i) const
+{
+    return !indef() && i / 2 >= size() ? item{} : nth(i);
+}
+
+/**
+ * @brief Find value of the first key which satisfies predicate. Keys are decoded one 
+ * by one, while values of non-matching keys are skipped without being decoded.
+ * 
+ * @tparam Fn Predicate type
+ * @param match Predicate, called with decoded key item
+ * @return Decoded value, or invalid item if key wasn't found or map is malformed
+ */
+template<class Fn>
+constexpr item dec::map::find_if(Fn match) const
+{
+    pointer p = data();
+    const pointer end = data() + seq::size();
+
+    for (size_t i = 0; indef() || i < size(); ++i) {
+
+        if (p < end && *p == 0xff)
+            break;
+
+        auto [key, e, next] = zbor::decode(p, end);
+
+        if (e != err_ok)
+            break;
+
+        if (match(key))
+            return std::get<item>(dec::decode(next, end, lazy()));
+
+        std::tie(e, p) = dec::skip(next, end, 1, 0);
+
+        if (e != err_ok)
+            break;
+    }
+    return {};
+}
+
+constexpr item dec::map::find(std::string_view key) const
+{
+    return find_if([&](const item& k) { return k.type == type_text && k.text == key; });
+}
+constexpr item dec::map::find(uint64_t key) const
+{
+    return find_if([&](const item& k) { return k.type == type_uint && k.uint == key; });
+}
+constexpr item dec::map::find(int64_t key) const
+{
+    if (key >= 0)
+        return find(uint64_t(key));
+    return find_if([&](const item& k) { return k.type == type_sint && k.sint == key; });
+}
+constexpr item dec::map::find(unsigned key) const               { return find(uint64_t(key)); }
+constexpr item dec::map::find(int key) const                    { return find(int64_t(key)); }
+constexpr item dec::map::operator[](std::string_view key) const { return find(key); }
+constexpr item dec::map::operator[](uint64_t key) const         { return find(key); }
+constexpr item dec::map::operator[](int64_t key) const          { return find(key); }
+constexpr item dec::map::operator[](unsigned key) const         { return find(key); }
+constexpr item dec::map::operator[](int key) const              { return find(key); }
 
 /**
  * @brief Get human readable name for type enum.
@@ -538,6 +1409,10 @@ constexpr auto str_err(err e)
         case err_invalid_simple: return "invalid_simple";
         case err_invalid_indef_mt: return "invalid_indef_mt";
         case err_invalid_indef_string: return "invalid_indef_string";
+        case err_invalid_type: return "invalid_type";
+        case err_limit_exceeded: return "limit_exceeded";
+        case err_trailing_bytes: return "trailing_bytes";
+        case err_invalid_length: return "invalid_length";
         default: return "<unknown>";
     }
 }
@@ -0,0 +1,121 @@
+#ifndef ZBOR_DYNAMIC_H
+#define ZBOR_DYNAMIC_H
+
+#include "zbor/enc.h"
+#include <memory>
+#include <utility>
+
+namespace zbor {
+
+/**
+ * @brief CBOR codec with storage allocated by Alloc, which grows geometrically
+ * whenever next item doesn't fit, so encoding never fails with err_no_memory
+ * unless allocator throws. Uses same CRTP codec interface as zbor::codec<>.
+ * Arena or any other memory resource can be used through allocator, e.g.
+ * std::pmr::polymorphic_allocator<byte>. Only zbor::cref is provided, since
+ * zbor::ref refers to fixed storage and can't grow it.
+ *
+ * @tparam Alloc Allocator of bytes
+ */
+template<class Alloc = std::allocator<byte>>
+struct dynamic_codec : enc::interface<dynamic_codec<Alloc>> {
+    friend enc::interface<dynamic_codec<Alloc>>;
+    using traits = std::allocator_traits<Alloc>;
+
+    constexpr dynamic_codec(const Alloc& alloc = {}) : alloc{alloc} {}
+    constexpr dynamic_codec(size_t len, const Alloc& alloc = {}) : alloc{alloc} { reserve(len); }
+    constexpr dynamic_codec(const dynamic_codec&) = delete;
+    constexpr dynamic_codec(dynamic_codec&& other) :
+        buf{std::exchange(other.buf, nullptr)},
+        idx{std::exchange(other.idx, 0)},
+        max{std::exchange(other.max, 0)},
+        alloc{std::move(other.alloc)} {}
+    constexpr dynamic_codec& operator=(const dynamic_codec&) = delete;
+    /**
+     * @brief Take over storage of other codec. If allocator doesn't propagate
+     * on move assignment (e.g. std::pmr::polymorphic_allocator) and differs,
+     * content is copied into storage of own allocator instead.
+     *
+     * @param other Codec, empty afterwards
+     * @return Reference to this
+     */
+    constexpr dynamic_codec& operator=(dynamic_codec&& other)
+    {
+        if (this == &other)
+            return *this;
+
+        if constexpr (traits::propagate_on_container_move_assignment::value) {
+            release();
+            alloc = std::move(other.alloc);
+        } else if (!(alloc == other.alloc)) {
+            // Storage of other can't be freed by own allocator
+            idx = 0;
+            if (reserve(other.idx)) {
+                if (other.idx)
+                    std::copy_n(other.buf, other.idx, buf);
+                idx = other.idx;
+            }
+            other.release();
+            other.idx = 0;
+            return *this;
+        } else {
+            release();
+        }
+        buf = std::exchange(other.buf, nullptr);
+        idx = std::exchange(other.idx, 0);
+        max = std::exchange(other.max, 0);
+        return *this;
+    }
+    constexpr ~dynamic_codec() { release(); }
+
+    constexpr operator cref() const { return {{buf, max}, idx}; }
+
+    /**
+     * @brief Preallocate storage, e.g. if expected size of output is known.
+     *
+     * @param len Minimal capacity in bytes
+     * @return True if storage has at least len bytes
+     */
+    constexpr bool reserve(size_t len)
+    {
+        return len <= max || realloc(len);
+    }
+
+    constexpr Alloc get_allocator() const { return alloc; }
+private:
+    constexpr bool grow(size_t len)
+    {
+        return realloc(std::max({len, max * 2, size_t(64)}));
+    }
+    constexpr bool realloc(size_t len)
+    {
+        byte* mem = traits::allocate(alloc, len);
+        if (!mem)
+            return false;
+        if (idx)
+            std::copy_n(buf, idx, mem);
+        release();
+        buf = mem;
+        max = len;
+        return true;
+    }
+    constexpr void release()
+    {
+        if (buf)
+            traits::deallocate(alloc, buf, max);
+        buf = nullptr;
+        max = 0;
+    }
+
+    byte* buf = nullptr;
+    size_t idx = 0;
+    size_t max = 0;
+    [[no_unique_address]] Alloc alloc;
+};
+
+template<std::integral T>
+dynamic_codec(T) -> dynamic_codec<>;
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "zbor/dec.h"
 #include <algorithm>
+#include <ranges>
 
 namespace zbor {
 namespace enc {
@@ -15,6 +16,8 @@ struct indef_txt    {};
 struct indef_arr    {};
 struct indef_map    {};
 struct breaker      {};
+struct f32          { float val; };     // Always single precision, see interface::encode_float32()
+struct f64          { double val; };    // Always double precision, see interface::encode_float64()
 template<size_t N>
 struct txt { 
     byte buf[N - 1]{};
@@ -24,6 +27,246 @@ struct txt {
 };
 template<class T>
 concept boolean = std::is_same<T, bool>::value;
+template<class T>
+struct builder;
+
+/**
+ * @brief Pre-encoded constant CBOR fragment, see zbor::fragment.
+ * 
+ * @tparam N Size in bytes
+ */
+template<size_t N>
+struct frag : std::array<byte, N> {};
+
+/**
+ * @brief Element type of number arrays, see interface::encode_array().
+ * 
+ */
+template<class T>
+concept number = (std::is_integral_v<T> && !boolean<T>) || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+/**
+ * @brief Write head with shortest argument, without bounds check.
+ * 
+ * @param p Output, must have at least 9 bytes
+ * @param mt Major type
+ * @param val Argument
+ * @return Pointer past head
+ */
+constexpr byte* put_head(byte* p, byte mt, uint64_t val)
+{
+    if (val <= ai_0) {
+        *p++ = mt | val;
+        return p;
+    }
+    byte len = val <= 0xff ? 1 : val <= 0xffff ? 2 : val <= 0xffffffff ? 4 : 8;
+    *p++ = mt | (ai_1 + std::countr_zero(len));
+    for (int i = 8 * len - 8; i >= 0; i -= 8)
+        *p++ = val >> i;
+    return p;
+}
+
+/**
+ * @brief Check if single precision value is exactly representable as half 
+ * precision, from its exponent and mantissa bits instead of round trip 
+ * conversion. NaN is included, since it's encoded as canonical half NaN.
+ * 
+ * @param f Single stored as uint32_t
+ * @return True if half precision is enough
+ */
+constexpr bool fits_half(uint32_t f)
+{
+    uint32_t a = f & 0x7fffffff;
+    uint32_t e = a >> 23;
+
+    // Normal half keeps 10 mantissa bits, subnormal less with every step down, 
+    // below that even hidden bit is lost. Combined without branches, since 
+    // widths of real data are hard to predict.
+    uint32_t sa = std::min<uint32_t>(e >= 113 ? 13 : 126 - e, 24);
+    bool exact = !(((a & 0x7fffff) | 0x800000) & ((1u << sa) - 1));
+    return (exact & (e <= 142)) | (a >= 0x7f800000) | (a == 0);
+}
+
+/**
+ * @brief Half precision bits of single precision value which fits_half(),
+ * taken directly from its exponent and mantissa bits. NaN becomes canonical
+ * half NaN.
+ * 
+ * @param f Single stored as uint32_t, must fit into half precision
+ * @return Half stored as uint16_t
+ */
+constexpr uint16_t half_bits(uint32_t f)
+{
+    uint32_t s = (f >> 16) & 0x8000;
+    uint32_t a = f & 0x7fffffff;
+    uint32_t e = a >> 23;
+
+    if (a > 0x7f800000)
+        return 0x7e00;
+    if (a == 0x7f800000)
+        return s | 0x7c00;
+    if (e >= 113)
+        return s | ((e - 112) << 10) | ((a & 0x7fffff) >> 13);
+    // Subnormal half (or zero): hidden bit shifted into mantissa
+    return a ? s | (((a & 0x7fffff) | 0x800000) >> (126 - e)) : s;
+}
+
+/**
+ * @brief Check if double precision value is exactly representable as single
+ * precision, without conversion. NaN and infinity are included.
+ * 
+ * @param d Double stored as uint64_t
+ * @return True if single precision is enough
+ */
+constexpr bool fits_float(uint64_t d)
+{
+    uint64_t a = d & 0x7fffffffffffffff;
+    uint64_t e = a >> 52;
+
+    if (a >= 0x7ff0000000000000)
+        return true;
+    if (e < 874 || e > 1150)
+        return a == 0;
+    // Normal single keeps 23 mantissa bits, subnormal less with every step down
+    uint64_t sa = e >= 897 ? 29 : 926 - e;
+    return !(((a & 0xfffffffffffff) | 0x10000000000000) & ((uint64_t(1) << sa) - 1));
+}
+
+/**
+ * @brief Check 8 adjacent single precision values with fits_half().
+ * 
+ * @param p Values, must have at least 8 elements
+ * @return Bit mask, bit i set if p[i] fits into half precision
+ */
+constexpr unsigned fits_half_8(const float* p)
+{
+#if defined(__AVX2__)
+    if (!std::is_constant_evaluated()) {
+        const __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i a = _mm256_and_si256(f, _mm256_set1_epi32(0x7fffffff));
+        const __m256i e = _mm256_srli_epi32(a, 23);
+        const __m256i sa = _mm256_max_epi32(_mm256_set1_epi32(13), _mm256_sub_epi32(_mm256_set1_epi32(126), e));
+        const __m256i low = _mm256_sub_epi32(_mm256_sllv_epi32(_mm256_set1_epi32(1), sa), _mm256_set1_epi32(1));
+        const __m256i m = _mm256_or_si256(_mm256_and_si256(a, _mm256_set1_epi32(0x7fffff)), _mm256_set1_epi32(0x800000));
+        const __m256i exact = _mm256_and_si256(
+            _mm256_cmpeq_epi32(_mm256_and_si256(m, low), _mm256_setzero_si256()),
+            _mm256_and_si256(_mm256_cmpgt_epi32(e, _mm256_set1_epi32(102)), _mm256_cmpgt_epi32(_mm256_set1_epi32(143), e)));
+        const __m256i special = _mm256_or_si256(
+            _mm256_cmpgt_epi32(a, _mm256_set1_epi32(0x7f7fffff)),
+            _mm256_cmpeq_epi32(a, _mm256_setzero_si256()));
+        return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(exact, special)));
+    }
+#endif
+    unsigned mask = 0;
+    for (int i = 0; i < 8; ++i)
+        mask |= fits_half(std::bit_cast<uint32_t>(p[i])) << i;
+    return mask;
+}
+
+/**
+ * @brief Write single precision value with its shortest width, without 
+ * bounds check.
+ * 
+ * @param p Output, must have at least 5 bytes
+ * @param f Single stored as uint32_t
+ * @param half Value fits into half precision, see fits_half()
+ * @param h Value converted to half precision, used if it fits
+ * @return Pointer past item
+ */
+constexpr byte* put_float(byte* p, uint32_t f, bool half, uint16_t h)
+{
+    if (half) {
+        if ((f & 0x7fffffff) > 0x7f800000)
+            h = 0x7e00;
+        p[0] = mt_simple | byte(prim_float_16);
+        p[1] = h >> 8;
+        p[2] = h;
+        return p + 3;
+    }
+    p[0] = mt_simple | byte(prim_float_32);
+    p[1] = f >> 24;
+    p[2] = f >> 16;
+    p[3] = f >> 8;
+    p[4] = f;
+    return p + 5;
+}
+
+/**
+ * @brief Write array elements without bounds check, see interface::encode_array().
+ * 
+ * @param p Output, must have space for worst case
+ * @param val Elements
+ * @param n Number of elements
+ * @return Pointer past last element
+ */
+template<number V>
+constexpr byte* put_array(byte* p, const V* val, size_t n)
+{
+    size_t i = 0;
+
+    if constexpr (std::is_same_v<V, float>) {
+#if defined(__AVX2__) && defined(__F16C__)
+        // Widths of 8 values are selected and their halves converted at once
+        for (; i + 8 <= n; i += 8) {
+            unsigned mask = fits_half_8(val + i);
+            uint16_t h[8]{};
+            if (mask)
+                utl::float_to_half_n(val + i, h, 8);
+            for (int k = 0; k < 8; ++k)
+                p = put_float(p, std::bit_cast<uint32_t>(val[i + k]), mask >> k & 1, h[k]);
+        }
+#endif
+        for (; i < n; ++i) {
+            uint32_t f = std::bit_cast<uint32_t>(val[i]);
+            bool half = fits_half(f);
+            p = put_float(p, f, half, half ? half_bits(f) : 0);
+        }
+    } else if constexpr (std::is_same_v<V, double>) {
+        for (; i < n; ++i) {
+            uint64_t u = std::bit_cast<uint64_t>(val[i]);
+            if (fits_float(u)) {
+                uint32_t f = std::bit_cast<uint32_t>(float(val[i]));
+                bool half = fits_half(f);
+                p = put_float(p, f, half, half ? half_bits(f) : 0);
+            } else {
+                *p++ = mt_simple | byte(prim_float_64);
+                for (int k = 56; k >= 0; k -= 8)
+                    *p++ = u >> k;
+            }
+        }
+    } else {
+        using U = std::make_unsigned_t<V>;
+        // Major type and argument of integer: negative are stored as ~val
+        auto split = [](V v) {
+            U s = std::is_signed_v<V> ? U(v >> (8 * sizeof(V) - 1)) : U(0);
+            return std::pair<byte, U>{byte(s & mt_nint), U(v) ^ s};
+        };
+        // Head and up to 4 argument bytes are written with single 8-byte store, 
+        // which is safe while at least 8 elements (16 bytes of worst case) remain
+        if constexpr (sizeof(V) <= 4 && std::endian::native == std::endian::little) {
+            if (!std::is_constant_evaluated()) {
+                for (; i + 8 <= n; ++i) {
+                    auto [mt, arg] = split(val[i]);
+                    // Arithmetic instead of conditions, which compilers turn into branches
+                    uint32_t m = arg;
+                    uint32_t wide = (m > 0xff) + (m > 0xffff);
+                    uint32_t small = -uint32_t(m <= ai_0);
+                    uint32_t len = (~small & 1) + wide + (m > 0xffff);
+                    byte ai = (m & small) | ((ai_1 + wide) & ~small);
+                    uint64_t w = (uint64_t(utl::byteswap(m)) << 8 >> (32 - 8 * len)) & ~uint64_t(0xff);
+                    w |= mt | ai;
+                    memcpy(p, &w, 8);
+                    p += 1 + len;
+                }
+            }
+        }
+        for (; i < n; ++i) {
+            auto [mt, arg] = split(val[i]);
+            p = put_head(p, mt, arg);
+        }
+    }
+    return p;
+}
 
 /**
  * @brief CBOR base codec implementation with CRTP interface.
@@ -90,6 +333,14 @@ struct interface {
     { 
         return encode_double(val);
     }
+    constexpr err encode(enc::f32 val)
+    { 
+        return encode_float32(val.val);
+    }
+    constexpr err encode(enc::f64 val)
+    { 
+        return encode_float64(val.val);
+    }
     constexpr err encode(span val)
     { 
         return encode_data(val); 
@@ -143,6 +394,11 @@ struct interface {
     {
         return encode_break();
     }
+    template<size_t N>
+    constexpr err encode(const enc::frag<N>& val)
+    {
+        return encode_frag(val);
+    }
 
     // ANCHOR: Explicit interface
 
@@ -165,26 +421,41 @@ struct interface {
     }
     constexpr err encode_float(float val)
     {
-        if (val != val)
-            return encode_nan();
-
         auto u32 = std::bit_cast<uint32_t>(val);
-        auto u16 = utl::float_to_half(u32);
 
-        if (val != std::bit_cast<float>(utl::half_to_float(u16)))
-            return encode_base(mt_simple | byte(prim_float_32), u32, 4);
-        
-        if ((u16 & 0x7fff) <= 0x7c00)
-            return encode_base(mt_simple | byte(prim_float_16), u16, 2);
-
-        return encode_nan();
+        if (enc::fits_half(u32))
+            return encode_base(mt_simple | byte(prim_float_16), enc::half_bits(u32), 2);
+        return encode_base(mt_simple | byte(prim_float_32), u32, 4);
     }
     constexpr err encode_double(double val)
     {
-        if (val != val)
-            return encode_nan();
-        if (val == float(val))
-            return encode_float(val);
+        auto u64 = std::bit_cast<uint64_t>(val);
+
+        if (enc::fits_float(u64))
+            return encode_float(float(val));
+        return encode_base(mt_simple | byte(prim_float_64), u64, 8);
+    }
+    /**
+     * @brief Encode single precision value always with 4 bytes, skipping
+     * search of shortest width (preferred serialization) when peer doesn't
+     * need it. NaN payload is kept as is.
+     * 
+     * @param val Value
+     * @return Error status
+     */
+    constexpr err encode_float32(float val)
+    {
+        return encode_base(mt_simple | byte(prim_float_32), std::bit_cast<uint32_t>(val), 4);
+    }
+    /**
+     * @brief Encode double precision value always with 8 bytes, see
+     * encode_float32().
+     * 
+     * @param val Value
+     * @return Error status
+     */
+    constexpr err encode_float64(double val)
+    {
         return encode_base(mt_simple | byte(prim_float_64), std::bit_cast<uint64_t>(val), 8);
     }
     constexpr err encode_data(span val)
@@ -205,11 +476,11 @@ struct interface {
     }
     err encode_text(std::string_view val)
     { 
-        return encode_string(mt_text, val.data(), val.size());
+        return encode_string(mt_text, reinterpret_cast<pointer>(val.data()), val.size());
     }
     err encode_text(const char* val)
     { 
-        return encode_string(mt_text, val, strlen(val)); 
+        return encode_string(mt_text, reinterpret_cast<pointer>(val), strlen(val)); 
     }
     template<size_t N>
     constexpr err encode_text(const enc::txt<N>& val)
@@ -248,18 +519,168 @@ struct interface {
     {
         return encode_byte(0xff); 
     }
+    template<size_t N>
+    constexpr err encode_frag(const enc::frag<N>& val)
+    {
+        if (!fits(N))
+            return err_no_memory;
+        std::copy_n(val.data(), N, buf() + idx());
+        idx() += N;
+        return err_ok;
+    }
+    /**
+     * @brief Encode array of numbers with the same shortest encoding as 
+     * encode_uint(), encode_sint(), encode_float() or encode_double() of 
+     * each element. Capacity for worst case is checked once and elements 
+     * are written in tight loop. Falls back to encoding element by element 
+     * if worst case doesn't fit. With AVX2 and F16C, width of 8 floats is 
+     * selected and their halves converted with utl::float_to_half_n() at once.
+     * 
+     * @param val Contiguous range of integers, floats or doubles
+     * @return Error status
+     */
+    template<std::ranges::contiguous_range R>
+        requires enc::number<std::ranges::range_value_t<R>>
+    constexpr err encode_array(const R& val)
+    {
+        using V = std::ranges::range_value_t<R>;
+        const V* src = std::ranges::data(val);
+        const size_t n = std::ranges::size(val);
+        // Integer takes at most 1 + sizeof(V), float 5 and double 9 bytes
+        const size_t worst = 1 + (std::is_same_v<V, float> ? 4 : std::is_same_v<V, double> ? 8 : sizeof(V));
+
+        if (!fits(9 + n * worst)) {
+            err e = encode_arr(n);
+            for (size_t i = 0; i < n && e == err_ok; ++i) {
+                if constexpr (std::is_same_v<V, float>)
+                    e = encode_float(src[i]);
+                else if constexpr (std::is_same_v<V, double>)
+                    e = encode_double(src[i]);
+                else if constexpr (std::is_signed_v<V>)
+                    e = encode_sint(src[i]);
+                else
+                    e = encode_uint(src[i]);
+            }
+            return e;
+        }
+        byte* p = enc::put_head(buf() + idx(), mt_array, n);
+        p = enc::put_array(p, src, n);
+        idx() = p - buf();
+        return err_ok;
+    }
+
+    // ANCHOR: Deferred length interface
+
+    /**
+     * @brief Start array which length is written by end() of returned handle. 
+     * Head is reserved with argument width for expected number of elements. 
+     * If actual number exceeds it, content is shifted once to widen the head, 
+     * otherwise head is patched in place (keeping reserved width).
+     * 
+     * @param expect Expected maximal number of elements
+     * @return Handle of the array
+     */
+    constexpr enc::builder<T> begin_arr(size_t expect = 0)
+    {
+        return begin_deferred(mt_array, expect);
+    }
+    /**
+     * @brief Start map which length is written by end() of returned handle, 
+     * see begin_arr().
+     * 
+     * @param expect Expected maximal number of key-value pairs
+     * @return Handle of the map
+     */
+    constexpr enc::builder<T> begin_map(size_t expect = 0)
+    {
+        return begin_deferred(mt_map, expect);
+    }
 private:
-    constexpr err encode_nan()
-    { 
-        return encode_base(mt_simple | byte(prim_float_16), 0x7e00, 2); 
+    friend enc::builder<T>;
+
+    constexpr enc::builder<T> begin_deferred(mt_t mt, size_t expect)
+    {
+        size_t head = idx();
+        err e = encode_head(mt, expect);
+        return {*this, head, e == err_ok ? byte(idx() - head - 1) : byte(0), mt, e, origin()};
+    }
+    static constexpr bool scattered()
+    {
+        // Payload of strings may be kept outside of storage, see encode_string(), 
+        // unless output before it leaves storage, see origin()
+        return requires (T& t, pointer data, size_t len) { t.refer(data, len); } && 
+            !requires (const T& t) { t.flushed(); };
+    }
+    constexpr size_t origin() const
+    {
+        // Output which already left storage, head of handle is lost once it grows
+        if constexpr (requires (const T& t) { t.flushed(); })
+            return static_cast<const T*>(this)->flushed();
+        return 0;
+    }
+    constexpr err end_deferred(size_t head, byte len, mt_t mt)
+    {
+        pointer p   = buf() + head + 1 + len;
+        pointer end = buf() + idx();
+        uint64_t n  = 0;
+        err e;
+
+        while (p < end) {
+            std::tie(e, p) = dec::skip(p, end, 1, 0);
+            if (e != err_ok)
+                return e;
+            ++n;
+        }
+        if (mt == mt_map) {
+            // Value of last key is missing
+            if (n & 1)
+                return err_out_of_bounds;
+            n >>= 1;
+        }
+        return end_deferred(head, len, mt, n);
+    }
+    constexpr err end_deferred(size_t head, byte len, mt_t mt, uint64_t n)
+    {
+        byte need = n <= ai_0 ? 0 : n <= 0xff ? 1 : n <= 0xffff ? 2 : n <= 0xffffffff ? 4 : 8;
+
+        if (need > len) {
+            // Backend which flushes on growth would pass stale head to sink
+            if constexpr (requires (const T& t) { t.flushed(); }) {
+                if (idx() > max() || size_t(need - len) > max() - idx())
+                    return err_no_memory;
+            } else if (!fits(need - len)) {
+                return err_no_memory;
+            }
+            auto body = buf() + head + 1 + len;
+            std::copy_backward(body, buf() + idx(), buf() + idx() + need - len);
+            idx() += need - len;
+            if constexpr (requires (T& t) { t.widen(head, len); })
+                static_cast<T*>(this)->widen(head, need - len);
+            len = need;
+        }
+        auto q = buf() + head;
+        *q++ = mt | (len ? ai_1 + std::countr_zero(len) : n);
+        for (int i = 8 * len - 8; i >= 0; i -= 8)
+            *q++ = n >> i;
+        return err_ok;
+    }
+private:
+    constexpr bool fits(size_t len)
+    {
+        // Without wraparound of idx() + len, so compilers see bound of writes
+        if (idx() <= max() && len <= max() - idx())
+            return true;
+        if constexpr (requires (T& t) { t.grow(len); })
+            return static_cast<T*>(this)->grow(idx() + len);
+        return false;
     }
     constexpr err encode_byte(byte b)
     { 
-        return idx() < max() ? buf()[idx()++] = b, err_ok : err_no_memory; 
+        return fits(1) ? buf()[idx()++] = b, err_ok : err_no_memory; 
     }
     constexpr err encode_base(byte start, uint64_t val, size_t ai_len, size_t add_len = 0)
     {
-        if (idx() + ai_len + add_len + 1 > max())
+        if (!fits(ai_len + add_len + 1))
             return err_no_memory;
         buf()[idx()++] = start;
         for (int i = 8 * ai_len - 8; i >= 0; i -= 8)
@@ -282,11 +703,17 @@ private:
         size_t ai_len = (ai <= ai_0) ? 0 : utl::bit(ai - ai_1);
         return encode_base(mt | ai, val, ai_len, add_len);
     }
-    constexpr err encode_string(mt_t mt, const void* data, size_t len)
+    constexpr err encode_string(mt_t mt, pointer data, size_t len)
     {
+        if constexpr (requires (T& t) { t.accepts(len); t.refer(data, len); }) {
+            if (static_cast<T*>(this)->accepts(len)) {
+                err e = encode_head(mt, len);
+                return e == err_ok ? static_cast<T*>(this)->refer(data, len) : e;
+            }
+        }
         err e = encode_head(mt, len, len);
         if (e == err_ok && len) {
-            std::copy_n(static_cast<pointer>(data), len, buf() + idx());
+            std::copy_n(data, len, buf() + idx());
             idx() += len;
         }
         return e;
@@ -299,6 +726,57 @@ private:
     constexpr auto& idx() const { return static_cast<const T*>(this)->idx; }
 };
 
+/**
+ * @brief Handle of array or map with deferred length, returned by 
+ * interface::begin_arr() and interface::begin_map(). Nested items are 
+ * encoded with codec as usual, then end() counts them and writes head. 
+ * Handle must not outlive codec.
+ * 
+ * @tparam T User class
+ */
+template<class T>
+struct builder {
+    /**
+     * @brief Count items encoded since handle was created and write 
+     * container head. Must be called after all nested items are encoded, 
+     * and before end() of enclosing handle.
+     * 
+     * Not available for codecs which keep string payload outside of 
+     * storage, e.g. zbor::gather_view, since items can't be counted there.
+     * 
+     * @return Error status, err_no_memory if head can't be widened or 
+     * already left storage, e.g. was flushed by zbor::stream_encoder
+     */
+    constexpr err end() requires (!interface<T>::scattered())
+    {
+        return e != err_ok ? e : moved() ? err_no_memory : codec.end_deferred(head, len, mt);
+    }
+    /**
+     * @brief Same as end(), but with number of elements (key-value pairs 
+     * for map) known by caller, so encoded items aren't counted.
+     * 
+     * @param size Number of elements
+     * @return Error status, same as end()
+     */
+    constexpr err end(size_t size)
+    {
+        return e != err_ok ? e : moved() ? err_no_memory : codec.end_deferred(head, len, mt, size);
+    }
+private:
+    friend interface<T>;
+    constexpr builder(interface<T>& codec, size_t head, byte len, mt_t mt, err e, size_t base) :
+        codec{codec}, head{head}, len{len}, mt{mt}, e{e}, base{base} {}
+
+    constexpr bool moved() const { return codec.origin() != base; }
+
+    interface<T>& codec;
+    size_t head;    // Offset of initial byte
+    byte len;       // Reserved argument width
+    mt_t mt;        // Major type
+    err e;          // Error of begin
+    size_t base;    // Output gone from storage at begin, see interface::origin()
+};
+
 /**
  * @brief Same as zbor::ref but const.
  * 
@@ -378,6 +856,53 @@ private:
     byte buf[N]{};
 };
 
+namespace enc {
+
+/**
+ * @brief Upper bound of encoded size of value.
+ * 
+ * @param val Any value accepted by interface::encode()
+ * @return Size in bytes
+ */
+consteval size_t bound(const auto& val)
+{
+    if constexpr (requires { val.size(); })
+        return val.size() + 9;
+    else
+        return 9;
+}
+
+/**
+ * @brief Encode values at compile time, see zbor::fragment.
+ * 
+ * @tparam Args Values accepted by interface::encode()
+ * @return Pre-encoded fragment of exact size
+ */
+template<auto... Args>
+consteval auto fragment()
+{
+    constexpr auto tmp = [] {
+        codec<(bound(Args) + ...)> c;
+        c.encode_(Args...);
+        return c;
+    }();
+    frag<tmp.size()> f{};
+    std::copy_n(tmp.data(), tmp.size(), f.begin());
+    return f;
+}
+
+}
+
+/**
+ * @brief Constant sequence of CBOR items encoded at compile time, e.g. map 
+ * header and constant key, which is spliced into output by interface::encode() 
+ * with single copy. For example: fragment<enc::map(2), "ts"_txt>.
+ * 
+ * @tparam Args Values accepted by interface::encode()
+ */
+template<auto... Args>
+inline constexpr auto fragment = enc::fragment<Args...>();
+
 namespace literals {
 
 constexpr auto operator"" _arr(unsigned long long x)    { return enc::arr(x); }
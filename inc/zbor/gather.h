@@ -0,0 +1,98 @@
+#ifndef ZBOR_GATHER_H
+#define ZBOR_GATHER_H
+
+#include "zbor/enc.h"
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#endif
+
+namespace zbor {
+
+#if __has_include(<sys/uio.h>)
+using iovec = ::iovec;
+#else
+struct iovec {
+    void* iov_base;
+    size_t iov_len;
+};
+#endif
+
+/**
+ * @brief CBOR codec with external storage, which doesn't copy large byte and
+ * text strings. Payload of string with at least threshold bytes is recorded
+ * as reference into iovec list, and only its head is written into storage,
+ * so output is scattered between storage and referenced user memory. Result
+ * is obtained with iov(), ready for writev() or sendmsg(). Referenced memory
+ * must outlive the output. Since storage alone isn't valid CBOR, iteration
+ * over codec doesn't apply and deferred length handle has only end() with count.
+ * If end() with count widens the head, recorded segments are moved along.
+ *
+ */
+struct gather_view : enc::interface<gather_view> {
+    friend enc::interface<gather_view>;
+    constexpr gather_view() = delete;
+    constexpr gather_view(std::span<byte> buf, std::span<iovec> vec, size_t threshold = 256) :
+        max{buf.size()}, buf{buf.data()}, vec{vec}, threshold{threshold} {}
+
+    /**
+     * @brief List of segments of output: storage and referenced strings in order.
+     * Valid until next encoding. List must have at least one entry, 
+     * otherwise it's empty.
+     *
+     * @return Span of iovec entries
+     */
+    constexpr std::span<const iovec> iov()
+    {
+        if (idx == seg || cnt == vec.size())
+            return vec.first(cnt);
+        vec[cnt] = segment(seg, idx - seg);
+        return vec.first(cnt + 1);
+    }
+    constexpr size_t total() const      { return idx + refs; }
+    constexpr size_t limit() const      { return threshold; }
+    constexpr void clear()              { idx = seg = cnt = refs = 0; }
+private:
+    constexpr bool accepts(size_t len) const
+    {
+        // Reference and preceding segment, one more slot is kept for the last segment
+        return len && len >= threshold && cnt + 3 <= vec.size();
+    }
+    constexpr err refer(pointer data, size_t len)
+    {
+        vec[cnt++] = segment(seg, idx - seg);
+        vec[cnt++] = {const_cast<byte*>(data), len};
+        seg = idx;
+        refs += len;
+        return err_ok;
+    }
+    constexpr void widen(size_t head, size_t by)
+    {
+        // Storage after head moved by given number of bytes, segment with head grew
+        for (size_t i = 0; i < cnt; i += 2) {
+            auto from = static_cast<byte*>(vec[i].iov_base) - buf;
+            if (from > ptrdiff_t(head))
+                vec[i].iov_base = buf + from + by;
+            else if (from + vec[i].iov_len > head)
+                vec[i].iov_len += by;
+        }
+        if (seg > head)
+            seg += by;
+    }
+    constexpr iovec segment(size_t from, size_t len) const
+    {
+        return {buf + from, len};
+    }
+
+    size_t idx = 0;
+    const size_t max;
+    byte* const buf;
+    std::span<iovec> vec;
+    size_t threshold;
+    size_t seg = 0;     // Offset of current segment in storage
+    size_t cnt = 0;     // Number of complete iovec entries
+    size_t refs = 0;    // Total size of referenced strings
+};
+
+}
+
+#endif
@@ -0,0 +1,552 @@
+#ifndef ZBOR_IDX_H
+#define ZBOR_IDX_H
+
+#include "zbor/dec.h"
+
+namespace zbor {
+namespace idx {
+
+/**
+ * @brief Tape entry, one per CBOR item in depth-first order. Nested items
+ * of container follow it directly, so subtree spans [i, next). Indefinite
+ * strings are single entries without chunks.
+ *
+ */
+struct node {
+    uint32_t head;  // Offset of initial byte
+    uint32_t tail;  // Offset past last byte of subtree
+    uint32_t next;  // Tape index past subtree
+    type_t type;    // Item type
+    uint64_t val;   // Count for arrays and maps (counted up to break if indefinite), tag number, string length (zero if indefinite) or value
+};
+
+/**
+ * @brief Hash table slot of map_index, empty if key is nullptr.
+ * 
+ */
+struct slot {
+    uint64_t hash;  // Hash of key
+    pointer key;    // Encoded key, value follows it
+};
+
+constexpr auto npos = uint32_t(-1);
+
+/**
+ * @brief Final mixing step of splitmix64.
+ * 
+ * @param x Value to mix
+ * @return Hash 
+ */
+constexpr uint64_t mix(uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Hash of text key, FNV-1a over characters.
+ * 
+ * @param str Either std::string_view or dec::txt
+ * @return Hash
+ */
+constexpr uint64_t hash(const auto& str)
+{
+    uint64_t h = 0xcbf29ce484222325;
+    for (auto c : str) {
+        h ^= byte(c);
+        h *= 0x100000001b3;
+    }
+    return mix(h ^ type_text);
+}
+
+/**
+ * @brief Hash of integer key.
+ * 
+ * @param val Argument of uint or sint
+ * @param t Either type_uint or type_sint
+ * @return Hash
+ */
+constexpr uint64_t hash(uint64_t val, type_t t)
+{
+    return mix(val + t * 0x9e3779b97f4a7c15);
+}
+
+}
+
+/**
+ * @brief Structural index (tape) of CBOR sequence. Built once in a single
+ * pass over provided buffer into user provided storage, after which size
+ * of any subtree, skipping over it and access to adjacent elements are
+ * O(1) without re-running decode(). Supports buffers up to 4 GiB.
+ *
+ */
+struct tape {
+    constexpr tape() = delete;
+    constexpr tape(std::span<idx::node> buf) : buf{buf} {}
+
+    /**
+     * @brief Build tape for given CBOR sequence, all validity checks of decode()
+     * are performed. On failure tape contains all entries parsed up to error.
+     *
+     * @param s CBOR sequence, must outlive the index
+     * @return Tuple with error status and pointer past last character interpreted
+     */
+    constexpr std::tuple<err, pointer> build(seq s)
+    {
+        src = s;
+        len = 0;
+
+        if (s.size() >= idx::npos)
+            return {err_no_memory, s.data()};
+
+        const pointer end = s.data() + s.size();
+        pointer p = s.data();
+        uint32_t open = idx::npos;
+
+        // NOTE: While container is open, its node keeps index of
+        // parent in "next" and remaining elements in "tail". Indefinite
+        // one counts its elements in "val" instead.
+
+        while (true) {
+
+            while (open != idx::npos && !buf[open].tail)
+                open = close(open, p);
+
+            if (p >= end) {
+                if (open != idx::npos)
+                    return {err_out_of_bounds, end};
+                break;
+            }
+            if (*p == 0xff) {
+                if (open == idx::npos || buf[open].tail != idx::npos)
+                    return {err_invalid_break, p + 1};
+                if (buf[open].type == type_map) {
+                    // Break instead of value
+                    if (buf[open].val & 1)
+                        return {err_invalid_break, p + 1};
+                    buf[open].val >>= 1;
+                }
+                open = close(open, ++p);
+                continue;
+            }
+            if (len >= buf.size())
+                return {err_no_memory, p};
+
+            auto [obj, e, next] = decode_lazy(p, end);
+
+            if (e != err_ok)
+                return {e, next};
+
+            auto& n = buf[len];
+
+            n.head = p - s.data();
+            n.type = obj.type;
+
+            if (open != idx::npos) {
+                if (buf[open].tail != idx::npos)
+                    --buf[open].tail;
+                else
+                    ++buf[open].val;
+            }
+
+            uint64_t cnt = 0;
+
+            switch (obj.type)
+            {
+            case type_array:
+                n.val = obj.arr.size();
+                cnt = n.val;
+            break;
+            case type_map:
+                n.val = obj.map.size();
+                cnt = n.val > uint64_t(end - next) ? n.val : n.val << 1;
+            break;
+            case type_tag:
+                n.val = obj.tag.num();
+                cnt = 1;
+            break;
+            case type_indef_data:
+            case type_indef_text:
+                std::tie(e, next) = dec::skip_istr(obj.type, next, end);
+                if (e != err_ok)
+                    return {e, next};
+                n.val = 0;
+            break;
+            case type_data:         n.val = obj.data.size(); break;
+            case type_text:         n.val = obj.text.size(); break;
+            case type_floating:     n.val = std::bit_cast<uint64_t>(obj.fp); break;
+            case type_prim:         n.val = obj.prim; break;
+            case type_sint:         n.val = obj.sint; break;
+            default:                n.val = obj.uint; break;
+            }
+            if ((*p & 0x1f) == ai_indef) {
+                cnt = idx::npos;
+                n.val = 0;
+            }
+            else if (cnt > uint64_t(end - next))
+                return {err_out_of_bounds, next};
+
+            p = next;
+
+            if (obj.type == type_array ||
+                obj.type == type_map ||
+                obj.type == type_tag)
+            {
+                n.tail = cnt;
+                n.next = open;
+                open = len++;
+            } else {
+                n.tail = p - s.data();
+                n.next = ++len;
+            }
+        }
+        return {err_ok, p};
+    }
+
+    /**
+     * @brief Decode item at given tape index. Containers are decoded lazily,
+     * but within exact bounds of their subtree, so no skipping takes place.
+     *
+     * @param i Tape index
+     * @return Decoded item
+     */
+    constexpr item get(size_t i) const
+    {
+        return std::get<item>(decode_lazy(src.data() + buf[i].head, src.data() + buf[i].tail));
+    }
+
+    /**
+     * @brief Get tape index of n-th element of container at given index.
+     * O(1) if container consists only of scalars, otherwise hops over
+     * subtrees of preceding elements.
+     *
+     * @param i Tape index of array, map or tag
+     * @param n Element number, for maps keys and values counted separately
+     * @return Tape index of element or idx::npos if out of range
+     */
+    constexpr size_t child(size_t i, size_t n) const
+    {
+        auto next = buf[i].next;
+        auto elem = i + 1 + n;
+
+        if (elem >= next)
+            return idx::npos;
+
+        if (next - i - 1 == count(i))
+            return elem;
+
+        for (elem = i + 1; n-- && elem < next; elem = buf[elem].next);
+
+        return elem < next ? elem : idx::npos;
+    }
+
+    /**
+     * @brief Get number of nested elements, for maps keys and values
+     * counted separately. Zero for everything except containers and tags.
+     *
+     * @param i Tape index
+     * @return Number of elements
+     */
+    constexpr size_t count(size_t i) const
+    {
+        switch (buf[i].type)
+        {
+        case type_array:
+        case type_map: return buf[i].val << (buf[i].type == type_map);
+        case type_tag: return 1;
+        default: return 0;
+        }
+    }
+
+    constexpr const idx::node& operator[](size_t i) const   { return buf[i]; }
+    constexpr const idx::node* begin() const                { return buf.data(); }
+    constexpr const idx::node* end() const                  { return buf.data() + len; }
+    constexpr size_t next(size_t i) const                   { return buf[i].next; }
+    constexpr size_t size() const                           { return len; }
+    constexpr size_t capacity() const                       { return buf.size(); }
+    constexpr seq source() const                            { return src; }
+private:
+    constexpr uint32_t close(uint32_t i, pointer p)
+    {
+        auto parent = buf[i].next;
+        buf[i].next = len;
+        buf[i].tail = p - src.data();
+        return parent;
+    }
+private:
+    std::span<idx::node> buf;
+    seq src;
+    size_t len = 0;
+};
+
+/**
+ * @brief Hash index over text and integer keys of a single map with user 
+ * provided slots (open addressing with linear probing). Built once in a 
+ * single pass, then every lookup decodes only matching key and its value. 
+ * Other key types aren't indexed. For duplicate keys first one wins, as 
+ * in dec::map::find().
+ * 
+ */
+struct map_index {
+    constexpr map_index() = delete;
+    constexpr map_index(std::span<idx::slot> buf) : buf{buf} {}
+
+    /**
+     * @brief Build index for given map. Number of slots must be greater than 
+     * number of indexed keys, twice as many is recommended.
+     * 
+     * @param m Decoded map, its memory must outlive the index
+     * @return Error status
+     */
+    constexpr err build(const dec::map& m)
+    {
+        len = 0;
+        end = m.data() + m.seq::size();
+        lazy = m.lazy();
+
+        for (auto& it : buf)
+            it = {};
+
+        pointer p = m.data();
+
+        for (size_t i = 0; m.indef() || i < m.size(); ++i) {
+
+            if (p < end && *p == 0xff)
+                break;
+
+            auto [key, e, next] = decode(p, end);
+
+            if (e != err_ok)
+                return e;
+
+            uint64_t h;
+
+            switch (key.type)
+            {
+            case type_text: h = idx::hash(key.text); break;
+            case type_uint: h = idx::hash(key.uint, type_uint); break;
+            case type_sint: h = idx::hash(key.sint, type_sint); break;
+            default: h = 0;
+            }
+            if (key.type == type_text || key.type == type_uint || key.type == type_sint) {
+
+                if (len + 1 >= buf.size())
+                    return err_no_memory;
+
+                auto j = h % buf.size();
+
+                while (buf[j].key)
+                    j = (j + 1) % buf.size();
+
+                buf[j] = {h, p};
+                ++len;
+            }
+            std::tie(e, p) = dec::skip(next, end, 1, 0);
+
+            if (e != err_ok)
+                return e;
+        }
+        return err_ok;
+    }
+
+    constexpr item find(std::string_view key) const
+    {
+        return lookup(idx::hash(key), [&](const item& k) { return k.type == type_text && k.text == key; });
+    }
+    constexpr item find(uint64_t key) const
+    {
+        return lookup(idx::hash(key, type_uint), [&](const item& k) { return k.type == type_uint && k.uint == key; });
+    }
+    constexpr item find(int64_t key) const
+    {
+        if (key >= 0)
+            return find(uint64_t(key));
+        return lookup(idx::hash(key, type_sint), [&](const item& k) { return k.type == type_sint && k.sint == key; });
+    }
+    constexpr item find(unsigned key) const                 { return find(uint64_t(key)); }
+    constexpr item find(int key) const                      { return find(int64_t(key)); }
+    constexpr item operator[](std::string_view key) const   { return find(key); }
+    constexpr item operator[](uint64_t key) const           { return find(key); }
+    constexpr item operator[](int64_t key) const            { return find(key); }
+    constexpr item operator[](unsigned key) const           { return find(key); }
+    constexpr item operator[](int key) const                { return find(key); }
+    constexpr size_t size() const                           { return len; }
+    constexpr size_t capacity() const                       { return buf.size(); }
+private:
+    template<class Fn>
+    constexpr item lookup(uint64_t h, Fn match) const
+    {
+        if (buf.empty())
+            return {};
+
+        for (auto j = h % buf.size(); buf[j].key; j = (j + 1) % buf.size()) {
+            if (buf[j].hash != h)
+                continue;
+            auto [key, e, next] = decode(buf[j].key, end);
+            if (match(key))
+                return std::get<item>(dec::decode(next, end, lazy));
+        }
+        return {};
+    }
+private:
+    std::span<idx::slot> buf;
+    pointer end = nullptr;
+    size_t len = 0;
+    bool lazy = false;
+};
+
+/**
+ * @brief Random access index over elements of a single array. If all elements 
+ * are scalars or definite strings of the same encoded width (e.g. all float32, 
+ * all uint with 1-byte argument), offset is computed arithmetically and no 
+ * storage is used. Otherwise offsets of every K-th element are stored in user 
+ * provided table, where K is the smallest step that fits into it, and access 
+ * skips at most K - 1 elements. Supports arrays up to 4 GiB.
+ * 
+ */
+struct arr_index {
+    constexpr arr_index() = default;
+    constexpr arr_index(std::span<uint32_t> buf) : buf{buf} {}
+
+    /**
+     * @brief Build index for given array.
+     * 
+     * @param a Decoded array, its memory must outlive the index
+     * @return Error status, err_no_memory if elements aren't uniform and no storage 
+     * provided. On error index is empty.
+     */
+    constexpr err build(const dec::arr& a)
+    {
+        err e = index(a);
+        if (e != err_ok)
+            len = width = step = 0;
+        return e;
+    }
+
+    /**
+     * @brief Get element by index.
+     * 
+     * @param i Element index
+     * @return Decoded element, or invalid item if out of range or index isn't built
+     */
+    constexpr item at(size_t i) const
+    {
+        if (i >= len)
+            return {};
+        if (width)
+            return std::get<item>(dec::decode(head + i * width, head + (i + 1) * width, lazy));
+        if (!step)
+            return {};
+
+        auto [e, p] = dec::skip(head + buf[i / step], end, i % step, 0);
+
+        if (e != err_ok)
+            return {};
+
+        return std::get<item>(dec::decode(p, end, lazy));
+    }
+
+    constexpr item operator[](size_t i) const   { return at(i); }
+    constexpr size_t size() const               { return len; }
+    constexpr size_t stride() const             { return width; }
+private:
+    constexpr err index(const dec::arr& a)
+    {
+        head = a.data();
+        end = a.data() + a.seq::size();
+        lazy = a.lazy();
+        len = a.size();
+        width = 0;
+        step = 0;
+
+        err e;
+        pointer p;
+
+        if (a.indef()) {
+            len = 0;
+            for (p = head; p < end && *p != 0xff; ++len) {
+                std::tie(e, p) = dec::skip(p, end, 1, 0);
+                if (e != err_ok)
+                    return e;
+            }
+            if (p >= end)
+                return err_out_of_bounds;
+        }
+        if (!len)
+            return err_ok;
+
+        if (uniform())
+            return err_ok;
+
+        if (buf.empty())
+            return err_no_memory;
+
+        step = (len + buf.size() - 1) / buf.size();
+        p = head;
+
+        for (size_t i = 0; i < len; ++i) {
+            if (i % step == 0) {
+                if (p - head >= idx::npos)
+                    return err_no_memory;
+                buf[i / step] = p - head;
+            }
+            std::tie(e, p) = dec::skip(p, end, 1, 0);
+            if (e != err_ok)
+                return e;
+        }
+        return err_ok;
+    }
+    constexpr size_t item_width(pointer p) const
+    {
+        if (p >= end)
+            return 0;
+
+        byte mt = *p & 0xe0;
+        byte ai = *p & 0x1f;
+
+        if (ai > ai_8 || mt == mt_array || mt == mt_map || mt == mt_tag)
+            return 0;
+
+        auto [e, val, next] = dec::ai_check(ai, p + 1, end);
+
+        if (e != err_ok)
+            return 0;
+
+        size_t w = next - p;
+
+        if (mt == mt_data || mt == mt_text) {
+            if (val > uint64_t(end - next))
+                return 0;
+            w += val;
+        }
+
+        return w;
+    }
+    constexpr bool uniform()
+    {
+        size_t w = item_width(head);
+
+        if (!w || len > size_t(end - head) / w)
+            return false;
+
+        for (size_t i = 1; i < len; ++i) {
+            if (item_width(head + i * w) != w)
+                return false;
+        }
+        width = w;
+        return true;
+    }
+private:
+    std::span<uint32_t> buf;
+    pointer head = nullptr;
+    pointer end = nullptr;
+    size_t len = 0;
+    size_t width = 0;
+    size_t step = 0;
+    bool lazy = false;
+};
+
+}
+
+#endif
@@ -0,0 +1,257 @@
+#ifndef ZBOR_MAPPED_H
+#define ZBOR_MAPPED_H
+
+#include "zbor/dec.h"
+#include <utility>
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if __has_include(<sys/mman.h>)
+
+namespace zbor {
+
+struct mapped_iter;
+
+/**
+ * @brief Read-only memory mapped file with CBOR sequence (RFC 8742), e.g.
+ * archive of records. File is mapped in windows of given size, which is
+ * remapped further as items are traversed, so files larger than address
+ * space friendly mappings are read without copying. Windows are advised for
+ * sequential access and transparent huge pages where supported. Items point
+ * into current window and stay valid until it's remapped, i.e. until next
+ * increment of iterator which crosses its end. Single item larger than window
+ * is mapped whole.
+ *
+ */
+struct mapped_seq {
+    static constexpr size_t default_window = size_t(1) << 30;
+
+    mapped_seq() = default;
+    explicit mapped_seq(const char* path, size_t window = default_window) { open(path, window); }
+    mapped_seq(const mapped_seq&) = delete;
+    mapped_seq(mapped_seq&& other) :
+        fd{std::exchange(other.fd, -1)},
+        len{std::exchange(other.len, 0)},
+        win{std::exchange(other.win, 0)},
+        map{std::exchange(other.map, nullptr)},
+        cnt{std::exchange(other.cnt, 0)},
+        base{std::exchange(other.base, 0)},
+        last{std::exchange(other.last, err_ok)} {}
+    mapped_seq& operator=(const mapped_seq&) = delete;
+    mapped_seq& operator=(mapped_seq&& other)
+    {
+        if (this != &other) {
+            close();
+            fd      = std::exchange(other.fd, -1);
+            len     = std::exchange(other.len, 0);
+            win     = std::exchange(other.win, 0);
+            map     = std::exchange(other.map, nullptr);
+            cnt     = std::exchange(other.cnt, 0);
+            base    = std::exchange(other.base, 0);
+            last    = std::exchange(other.last, err_ok);
+        }
+        return *this;
+    }
+    ~mapped_seq() { close(); }
+
+    /**
+     * @brief Open file and map its first window.
+     *
+     * @param path File path
+     * @param window Size of mapping, rounded up to page size
+     * @return True if file is open and mapped (empty file isn't mapped)
+     */
+    bool open(const char* path, size_t window = default_window)
+    {
+        close();
+
+        fd = ::open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (::fstat(fd, &st) || st.st_size < 0) {
+            close();
+            return false;
+        }
+        size_t page = size_t(::sysconf(_SC_PAGESIZE));
+        len = uint64_t(st.st_size);
+        win = std::max(window + page - 1, page) / page * page;
+
+        if (len && !remap(0, 0)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+        unmap();
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+        len = base = 0;
+        last = err_ok;
+    }
+
+    bool is_open() const            { return fd >= 0; }
+    uint64_t size() const           { return len; }     // File size
+    uint64_t offset() const         { return base; }    // File offset of current window
+    err status() const              { return last; }    // Error which stopped traversal
+    seq window() const              { return {map, cnt}; }
+
+    /**
+     * @brief Map window which starts at page containing given offset.
+     *
+     * @param off File offset
+     * @param need Minimal number of bytes mapped from offset, window size if less
+     * @return True if mapped, otherwise current window is kept
+     */
+    bool remap(uint64_t off, size_t need)
+    {
+        if (off >= len)
+            return false;
+
+        size_t page = size_t(::sysconf(_SC_PAGESIZE));
+        uint64_t from = off / page * page;
+        uint64_t to = std::min(len, std::max(from + win, off + need));
+
+        // Old window is released only when new one exists, items may still point into it
+        void* mem = ::mmap(nullptr, size_t(to - from), PROT_READ, MAP_PRIVATE, fd, off_t(from));
+        if (mem == MAP_FAILED)
+            return false;
+
+        unmap();
+        map = static_cast<byte*>(mem);
+        cnt = size_t(to - from);
+        base = from;
+        ::madvise(mem, cnt, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+        ::madvise(mem, cnt, MADV_HUGEPAGE);
+#endif
+        return true;
+    }
+
+    mapped_iter begin();
+    mapped_iter end();
+private:
+    friend mapped_iter;
+
+    void unmap()
+    {
+        if (map)
+            ::munmap(const_cast<byte*>(map), cnt);
+        map = nullptr;
+        cnt = 0;
+    }
+
+    int fd = -1;
+    uint64_t len = 0;       // File size
+    size_t win = 0;         // Window size
+    pointer map = nullptr;
+    size_t cnt = 0;         // Size of current window
+    uint64_t base = 0;      // File offset of current window
+    err last = err_ok;
+};
+
+/**
+ * @brief Iterator over items of mapped_seq, which yields pair of item and its
+ * file offset, e.g. for building index. Item which is truncated by end of
+ * window is decoded again after remapping. Stops at end of file or anything
+ * malformed, in which case mapped_seq::status() tells error.
+ *
+ */
+struct mapped_iter {
+    mapped_iter() = default;
+    mapped_iter(mapped_seq* file) : file{file}
+    {
+        step();
+    }
+    bool operator!=(const mapped_iter&) const
+    {
+        return obj.valid();
+    }
+    auto operator*() const
+    {
+        return std::pair<const item&, uint64_t>{obj, at};
+    }
+    auto& operator++()
+    {
+        step();
+        return *this;
+    }
+private:
+    void step()
+    {
+        obj = {};
+
+        if (!file || next >= file->len)
+            return;
+
+        while (true) {
+
+            if ((next < file->base || next >= file->base + file->cnt) && !file->remap(next, 0)) {
+                file->last = err_no_memory;
+                return;
+            }
+
+            pointer p = file->map + (next - file->base);
+            pointer end = file->map + file->cnt;
+            auto [o, e, q] = decode(p, end);
+
+            if (e == err_out_of_bounds && file->base + file->cnt < file->len) {
+                // Item which declares more than rest of file isn't remapped,
+                // otherwise window grows at least twice for undeclared part
+                uint64_t need = extent(p, end);
+                if (need > file->len - next) {
+                    file->last = err_out_of_bounds;
+                    return;
+                }
+                if (!file->remap(next, size_t(std::max(need, uint64_t(end - p) * 2)))) {
+                    file->last = err_no_memory;
+                    return;
+                }
+                continue;
+            }
+            if (e != err_ok) {
+                file->last = e;
+                return;
+            }
+            obj = o;
+            at = next;
+            next += uint64_t(q - p);
+            return;
+        }
+    }
+
+    // Lower bound of item size declared by its head: payload of string or
+    // at least one byte per nested item
+    static uint64_t extent(pointer p, pointer end)
+    {
+        auto& h = dec::heads[*p];
+        auto [e, val, q] = dec::ai_check(*p & 0x1f, p + 1, end);
+        if (e != err_ok || (h.flags & dec::head_special))
+            return 1 + h.len + ((h.flags & dec::head_indef) != 0);
+        uint64_t n = std::min(val, uint64_t(-1) >> 2);
+        return uint64_t(q - p) + (h.flags & dec::head_string ? n : n * h.mul + h.add);
+    }
+
+    mapped_seq* file = nullptr;
+    item obj;
+    uint64_t at = 0;        // File offset of current item
+    uint64_t next = 0;      // File offset of next item
+};
+
+inline mapped_iter mapped_seq::begin()  { last = err_ok; return {this}; }
+inline mapped_iter mapped_seq::end()    { return {}; }
+
+}
+
+#endif
+
+#endif
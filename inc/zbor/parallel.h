@@ -0,0 +1,243 @@
+#ifndef ZBOR_PARALLEL_H
+#define ZBOR_PARALLEL_H
+
+#include "zbor/dec.h"
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace zbor {
+
+/**
+ * @brief Order of callbacks of zbor::parallel_for_each().
+ *
+ */
+enum par_order {
+    par_unordered,  // Callbacks run concurrently on workers in any order
+    par_ordered,    // Items are decoded on workers, callbacks run one at a time in sequence order
+};
+
+/**
+ * @brief Options of zbor::parallel_for_each().
+ *
+ */
+struct par_options {
+    size_t threads  = 0;                // Worker threads, hardware concurrency if zero
+    size_t chunk    = size_t(1) << 20;  // Bytes of items per task, at least one item
+    par_order order = par_unordered;
+};
+
+namespace par {
+
+/**
+ * @brief Contiguous range of top-level items processed by single worker.
+ *
+ */
+struct task {
+    pointer head;
+    pointer tail;
+    size_t index;   // Index of first item in sequence
+    size_t id;      // Index of task in sequence
+};
+
+/**
+ * @brief Boundary scan: skip items without decoding them (see dec::skip())
+ * until at least given number of bytes is covered.
+ *
+ * @param p Pointer to first item, must be valid pointer
+ * @param end End pointer, must be valid pointer
+ * @param bytes Minimal number of bytes to cover
+ * @return Tuple with error status, pointer past last skipped item and number of items
+ */
+inline std::tuple<err, pointer, size_t> scan(pointer p, const pointer end, size_t bytes)
+{
+    const pointer stop = end - p > ptrdiff_t(bytes) ? p + bytes : end;
+    size_t n = 0;
+
+    while (p < stop) {
+        auto [e, next] = dec::skip(p, end, 1, 0);
+        if (e != err_ok)
+            return {e, p, n};
+        p = next;
+        ++n;
+    }
+    return {err_ok, p, n};
+}
+
+}
+
+/**
+ * @brief Decode CBOR sequence (RFC 8742) on multiple threads and call fn(item, index)
+ * for every top-level item. Calling thread scans boundaries of items (only heads are
+ * interpreted, see par::scan()) and queues ranges of about options::chunk bytes, which
+ * workers decode while scanning continues. At most two ranges per worker are queued or
+ * being processed, so memory use doesn't depend on size of input. Index of item in
+ * sequence is the same for any number of threads, so results stored by index are
+ * deterministic. With par_unordered callbacks must be thread-safe. With par_ordered
+ * they are serialized in sequence order, so only decoding is parallel. Traversal ends
+ * at first malformed item: with par_ordered no item after it is visited, with
+ * par_unordered ranges which follow it may already be visited when it's found.
+ * Exception thrown by callback stops traversal and is rethrown after workers finish.
+ *
+ * @param in CBOR sequence
+ * @param fn Callback, called with decoded item and its index
+ * @param opt Options
+ * @return Tuple with error status of first malformed item and its offset, or size of
+ * input if all items are valid
+ */
+template<class Fn>
+std::tuple<err, size_t> parallel_for_each(const seq& in, Fn&& fn, const par_options& opt = {})
+{
+    const pointer begin = in.data();
+    const pointer end = in.data() + in.size();
+    const size_t threads = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    const size_t limit = 2 * threads;
+
+    std::mutex mtx;
+    std::condition_variable ready;  // Task queued or scan finished
+    std::condition_variable room;   // Task finished, so next one may be queued
+    std::condition_variable turn;   // Previous task finished callbacks, par_ordered only
+    std::deque<par::task> queue;
+    bool done = false;
+    size_t pending = 0;             // Tasks queued or being processed
+    size_t next = 0;                // Task id whose callbacks may run, par_ordered only
+    err fail = err_ok;
+    pointer at = end;
+    std::exception_ptr thrown;
+
+    auto report = [&](err e, pointer p) {
+        std::lock_guard lock{mtx};
+        if (p < at) {
+            fail = e;
+            at = p;
+        }
+    };
+    auto abort = [&] {
+        std::lock_guard lock{mtx};
+        if (!thrown)
+            thrown = std::current_exception();
+    };
+    // Range follows malformed item or callback has thrown
+    auto skipped = [&](const par::task& t) {
+        std::lock_guard lock{mtx};
+        return t.head >= at || thrown;
+    };
+
+    auto work = [&] {
+        std::vector<item> items;
+
+        while (true) {
+            par::task t;
+            {
+                std::unique_lock lock{mtx};
+                ready.wait(lock, [&] { return !queue.empty() || done; });
+                if (queue.empty())
+                    return;
+                t = queue.front();
+                queue.pop_front();
+            }
+            items.clear();
+
+            if (!skipped(t)) {
+                try {
+                    pointer p = t.head;
+
+                    for (size_t i = t.index; p < t.tail; ++i) {
+                        auto [obj, res, q] = decode(p, t.tail);
+                        if (res != err_ok) {
+                            report(res, p);
+                            break;
+                        }
+                        if (opt.order == par_unordered)
+                            fn(std::as_const(obj), i);
+                        else
+                            items.push_back(obj);
+                        p = q;
+                    }
+                } catch (...) {
+                    abort();
+                }
+            }
+            if (opt.order == par_ordered) {
+                {
+                    std::unique_lock lock{mtx};
+                    turn.wait(lock, [&] { return next == t.id; });
+                }
+                // All preceding ranges are done, so any malformed item before this one is known
+                if (!skipped(t)) {
+                    try {
+                        for (size_t i = 0; i < items.size(); ++i)
+                            fn(std::as_const(items[i]), t.index + i);
+                    } catch (...) {
+                        abort();
+                    }
+                }
+            }
+            std::lock_guard lock{mtx};
+            ++next;
+            --pending;
+            turn.notify_all();
+            room.notify_one();
+        }
+    };
+
+    std::vector<std::thread> workers;
+
+    // Workers are joined also if scan or thread creation throws
+    struct joiner {
+        std::vector<std::thread>& workers;
+        std::mutex& mtx;
+        std::condition_variable& ready;
+        bool& done;
+        ~joiner()
+        {
+            {
+                std::lock_guard lock{mtx};
+                done = true;
+                ready.notify_all();
+            }
+            for (auto& w : workers)
+                w.join();
+        }
+    };
+    {
+        joiner guard{workers, mtx, ready, done};
+
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i)
+            workers.emplace_back(work);
+
+        pointer p = begin;
+        size_t index = 0;
+
+        for (size_t id = 0; p < end; ++id) {
+            auto [e, q, n] = par::scan(p, end, std::max<size_t>(opt.chunk, 1));
+            if (n) {
+                std::unique_lock lock{mtx};
+                room.wait(lock, [&] { return pending < limit; });
+                if (p >= at || thrown)
+                    break;
+                queue.push_back({p, q, index, id});
+                ++pending;
+                ready.notify_one();
+            }
+            if (e != err_ok) {
+                report(e, q);
+                break;
+            }
+            index += n;
+            p = q;
+        }
+    }
+    if (thrown)
+        std::rethrow_exception(thrown);
+
+    return {fail, size_t(at - begin)};
+}
+
+}
+
+#endif
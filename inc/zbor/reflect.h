@@ -0,0 +1,355 @@
+#ifndef ZBOR_REFLECT_H
+#define ZBOR_REFLECT_H
+
+#include "zbor/enc.h"
+#include <limits>
+#include <ranges>
+#include <string>
+
+/**
+ * @brief Describe struct for zbor::encode() and zbor::decode_into(), which
+ * map it to CBOR map with field names as text keys, in listed order. Must be
+ * placed in the namespace of the struct (found by ADL). Every name is bound
+ * to the member of the same name, so misspelled name doesn't compile.
+ * For example: struct point { int x; int y; }; ZBOR_FIELDS(point, x, y)
+ *
+ */
+#define ZBOR_FIELDS(T, ...) \
+    constexpr auto zbor_fields(T& zbor_obj_)        { return std::tie(ZBOR_FOR_EACH(ZBOR_MEMBER, __VA_ARGS__)); } \
+    constexpr auto zbor_fields(const T& zbor_obj_)  { return std::tie(ZBOR_FOR_EACH(ZBOR_MEMBER, __VA_ARGS__)); } \
+    consteval std::string_view zbor_names(const T*) { return #__VA_ARGS__; }
+
+#define ZBOR_MEMBER(name) zbor_obj_.name
+
+// Apply macro to every argument, separated by comma, up to 256 arguments
+#define ZBOR_FOR_EACH(m, ...)       __VA_OPT__(ZBOR_EXPAND(ZBOR_FOR_EACH_(m, __VA_ARGS__)))
+#define ZBOR_FOR_EACH_(m, a, ...)   m(a) __VA_OPT__(, ZBOR_FOR_EACH_AGAIN ZBOR_PARENS (m, __VA_ARGS__))
+#define ZBOR_FOR_EACH_AGAIN()       ZBOR_FOR_EACH_
+#define ZBOR_PARENS ()
+#define ZBOR_EXPAND(...)    ZBOR_EXPAND3(ZBOR_EXPAND3(ZBOR_EXPAND3(ZBOR_EXPAND3(__VA_ARGS__))))
+#define ZBOR_EXPAND3(...)   ZBOR_EXPAND2(ZBOR_EXPAND2(ZBOR_EXPAND2(ZBOR_EXPAND2(__VA_ARGS__))))
+#define ZBOR_EXPAND2(...)   ZBOR_EXPAND1(ZBOR_EXPAND1(ZBOR_EXPAND1(ZBOR_EXPAND1(__VA_ARGS__))))
+#define ZBOR_EXPAND1(...)   __VA_ARGS__
+
+namespace zbor {
+namespace refl {
+
+/**
+ * @brief Struct described with ZBOR_FIELDS.
+ *
+ */
+template<class T>
+concept reflected = requires(T& obj) {
+    zbor_fields(obj);
+    zbor_names(static_cast<const T*>(nullptr));
+};
+
+/**
+ * @brief Hash of key for field lookup. Unless full, only length, first,
+ * middle and last characters are mixed, which is enough to tell apart
+ * field names of most structs.
+ *
+ * @param p Key characters
+ * @param len Key length
+ * @param seed Seed found by perfect()
+ * @param full Mix all characters
+ * @return Hash value
+ */
+template<class C>
+constexpr uint32_t hash(const C* p, size_t len, uint32_t seed, bool full)
+{
+    uint32_t h = (seed ^ uint32_t(len)) * 0x9e3779b1;
+    if (full) {
+        for (size_t i = 0; i < len; ++i)
+            h = (h ^ byte(p[i])) * 0x01000193;
+    } else if (len) {
+        h = (h ^ byte(p[0])) * 0x01000193;
+        h = (h ^ byte(p[len / 2])) * 0x01000193;
+        h = (h ^ byte(p[len - 1])) * 0x01000193;
+    }
+    return h ^ (h >> 16);
+}
+
+/**
+ * @brief Perfect hash table of N keys: every key has its own slot.
+ *
+ * @tparam N Number of keys
+ */
+template<size_t N>
+struct table {
+    static constexpr size_t mask = std::bit_ceil(N * 4) - 1;
+    uint32_t seed = 0;
+    bool full = false;
+    bool ok = false;                    // False if no seed was found
+    std::array<byte, mask + 1> slot{};  // Key index + 1, zero if empty
+};
+
+/**
+ * @brief Search seed for which hash() of keys doesn't collide, first with
+ * sampled and then with all characters.
+ *
+ * @param keys Keys
+ * @return Perfect hash table, or table with ok unset if keys still collide
+ * (e.g. duplicate or too many keys)
+ */
+template<size_t N>
+consteval table<N> perfect(const std::array<std::string_view, N>& keys)
+{
+    table<N> t;
+
+    if (N >= 256)
+        return t;
+    for (bool full : {false, true}) {
+        for (uint32_t seed = 0; seed < 4096; ++seed) {
+            t = {seed, full, true};
+            for (size_t i = 0; i < N && t.ok; ++i) {
+                auto& s = t.slot[hash(keys[i].data(), keys[i].size(), seed, full) & t.mask];
+                t.ok = !s;
+                s = byte(i + 1);
+            }
+            if (t.ok)
+                return t;
+        }
+    }
+    return {};
+}
+
+/**
+ * @brief Split stringified list of field names.
+ *
+ * @param str Names separated by comma
+ * @return Array of names
+ */
+template<size_t N>
+consteval auto split(std::string_view str)
+{
+    std::array<std::string_view, N> out{};
+    for (auto& name : out) {
+        str.remove_prefix(std::min(str.find_first_not_of(' '), str.size()));
+        name = str.substr(0, std::min(str.find_first_of(", "), str.size()));
+        str.remove_prefix(std::min(str.find(',') + 1, str.size()));
+    }
+    return out;
+}
+
+/**
+ * @brief Encode field name as text string at compile time.
+ *
+ * @tparam N Length of name
+ * @param name Field name
+ * @return Pre-encoded key of exact size (head has 1, 2 or 3 bytes)
+ */
+template<size_t N>
+consteval auto key(std::string_view name)
+{
+    std::array<byte, N> str{};
+    std::copy_n(name.begin(), N, str.begin());
+    codec<N + 9> c;
+    c.encode_text(span(str.data(), N));
+    enc::frag<N + (N < 24 ? 1 : N < 256 ? 2 : 3)> f{};
+    std::copy_n(c.data(), f.size(), f.begin());
+    return f;
+}
+
+/**
+ * @brief Compile-time description of reflected struct: field names,
+ * their pre-encoded keys and perfect hash table for lookup.
+ *
+ * @tparam T Struct described with ZBOR_FIELDS
+ */
+template<reflected T>
+struct meta {
+    static constexpr size_t size = std::tuple_size_v<decltype(zbor_fields(std::declval<T&>()))>;
+    static constexpr auto names = split<size>(zbor_names(static_cast<const T*>(nullptr)));
+    static constexpr auto index = perfect(names);
+
+    template<size_t I>
+    static constexpr auto key = refl::key<names[I].size()>(names[I]);
+
+    /**
+     * @brief Find field by key with single hash lookup and comparison, or
+     * by comparison with every name if perfect hash wasn't found.
+     *
+     * @param key Decoded text key
+     * @return Field index, or size if key doesn't name any field
+     */
+    static constexpr size_t find(const dec::txt& key)
+    {
+        if constexpr (index.ok) {
+            size_t s = index.slot[hash(key.data(), key.size(), index.seed, index.full) & index.mask];
+            return s && key == names[s - 1] ? s - 1 : size;
+        }
+        size_t i = 0;
+        while (i < size && !(key == names[i]))
+            ++i;
+        return i;
+    }
+};
+
+}
+
+template<class C, class T>
+constexpr err encode(enc::interface<C>& codec, const T& val);
+template<class T>
+constexpr err decode_into(const item& obj, T& val);
+
+namespace refl {
+
+template<class C, class T, size_t... I>
+constexpr err encode(enc::interface<C>& codec, const T& val, std::index_sequence<I...>)
+{
+    auto fields = zbor_fields(val);
+    err e = codec.encode_map(sizeof...(I));
+    if (e != err_ok)
+        return e;
+    (((e = codec.encode(meta<T>::template key<I>)) || (e = zbor::encode(codec, std::get<I>(fields)))) || ...);
+    return e;
+}
+
+template<class T, size_t... I>
+constexpr err decode_into(const dec::map& map, T& val, std::index_sequence<I...>)
+{
+    auto fields = zbor_fields(val);
+    err e = err_ok;
+    auto it = map.begin();
+
+    for (; it != map.end(); ++it) {
+        auto [k, v] = *it;
+        if (k.type != type_text)
+            continue;
+        size_t i = meta<T>::find(k.text);
+        ((i == I ? (e = zbor::decode_into(v, std::get<I>(fields)), true) : false) || ...);
+        if (e != err_ok)
+            return e;
+    }
+    return it.error();
+}
+
+}
+
+/**
+ * @brief Encode value generated at compile time. Struct described with
+ * ZBOR_FIELDS is encoded as map with pre-encoded field names as keys,
+ * ranges other than strings as arrays (contiguous ranges of numbers with
+ * interface::encode_array()), anything else with interface::encode().
+ *
+ * @param codec Any codec
+ * @param val Value to encode
+ * @return Error status
+ */
+template<class C, class T>
+constexpr err encode(enc::interface<C>& codec, const T& val)
+{
+    if constexpr (refl::reflected<T>) {
+        return refl::encode(codec, val, std::make_index_sequence<refl::meta<T>::size>{});
+    } else if constexpr (requires { codec.encode(val); }) {
+        return codec.encode(val);
+    } else if constexpr (requires { codec.encode_array(val); }) {
+        return codec.encode_array(val);
+    } else {
+        static_assert(std::ranges::sized_range<const T>, "type can't be encoded");
+        err e = codec.encode_arr(std::ranges::size(val));
+        for (auto it = std::ranges::begin(val); it != std::ranges::end(val) && e == err_ok; ++it)
+            e = zbor::encode(codec, *it);
+        return e;
+    }
+}
+
+/**
+ * @brief Decode item into value, counterpart of zbor::encode(). Keys of
+ * maps are compared with field names of reflected struct, unknown keys are 
+ * ignored and fields of missing keys left unchanged.
+ * Containers with push_back() are cleared and filled, fixed size arrays
+ * must match exactly. Byte containers are decoded from byte strings.
+ * Integers must fit into destination type.
+ *
+ * @param obj Decoded item
+ * @param val Destination value
+ * @return Error status, err_invalid_type if item doesn't match type of value, 
+ * or error which stopped traversal of malformed container
+ */
+template<class T>
+constexpr err decode_into(const item& obj, T& val)
+{
+    if constexpr (refl::reflected<T>) {
+        if (obj.type != type_map)
+            return err_invalid_type;
+        return refl::decode_into(obj.map, val, std::make_index_sequence<refl::meta<T>::size>{});
+    } else if constexpr (std::is_same_v<T, bool>) {
+        if (obj.type != type_prim || (obj.prim != prim_true && obj.prim != prim_false))
+            return err_invalid_type;
+        val = obj.prim == prim_true;
+    } else if constexpr (std::is_integral_v<T>) {
+        if (obj.type == type_uint && obj.uint <= uint64_t(std::numeric_limits<T>::max()))
+            val = T(obj.uint);
+        else if (std::is_signed_v<T> && obj.type == type_sint && obj.sint < 0 && obj.sint >= int64_t(std::numeric_limits<T>::min()))
+            val = T(obj.sint);
+        else
+            return err_invalid_type;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        switch (obj.type)
+        {
+        case type_floating: val = T(obj.fp); break;
+        case type_uint: val = T(obj.uint); break;
+        case type_sint: val = T(obj.sint); break;
+        default: return err_invalid_type;
+        }
+    } else if constexpr (std::is_same_v<T, dec::txt>) {
+        if (obj.type != type_text)
+            return err_invalid_type;
+        val = obj.text;
+    } else if constexpr (std::is_same_v<T, std::string_view>) {
+        if (obj.type != type_text)
+            return err_invalid_type;
+        val = {reinterpret_cast<const char*>(obj.text.data()), obj.text.size()};
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        if (obj.type != type_text)
+            return err_invalid_type;
+        val.assign(obj.text.begin(), obj.text.end());
+    } else if constexpr (std::is_same_v<T, span>) {
+        if (obj.type != type_data)
+            return err_invalid_type;
+        val = obj.data;
+    } else if constexpr (requires { val.push_back(byte{}); } && std::is_same_v<std::ranges::range_value_t<T>, byte>) {
+        if (obj.type != type_data)
+            return err_invalid_type;
+        val.assign(obj.data.begin(), obj.data.end());
+    } else if constexpr (requires { val.push_back(std::ranges::range_value_t<T>{}); }) {
+        if (obj.type != type_array)
+            return err_invalid_type;
+        val.clear();
+        auto it = obj.arr.begin();
+        for (; it != obj.arr.end(); ++it) {
+            if (err e = zbor::decode_into(*it, val.emplace_back()); e != err_ok)
+                return e;
+        }
+        return it.error();
+    } else {
+        static_assert(std::ranges::sized_range<T>, "type can't be decoded");
+        if constexpr (std::is_same_v<std::ranges::range_value_t<T>, byte>) {
+            if (obj.type != type_data || obj.data.size() != std::ranges::size(val))
+                return err_invalid_type;
+            std::ranges::copy(obj.data, std::ranges::begin(val));
+        } else {
+            if (obj.type != type_array)
+                return err_invalid_type;
+            auto dst = std::ranges::begin(val);
+            auto it = obj.arr.begin();
+            for (; it != obj.arr.end(); ++it) {
+                if (dst == std::ranges::end(val))
+                    return err_invalid_type;
+                if (err e = zbor::decode_into(*it, *dst++); e != err_ok)
+                    return e;
+            }
+            if (it.error() != err_ok)
+                return it.error();
+            if (dst != std::ranges::end(val))
+                return err_invalid_type;
+        }
+    }
+    return err_ok;
+}
+
+}
+
+#endif
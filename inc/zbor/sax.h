@@ -0,0 +1,275 @@
+#ifndef ZBOR_SAX_H
+#define ZBOR_SAX_H
+
+#include "zbor/dec.h"
+
+namespace zbor {
+namespace sax {
+
+/**
+ * @brief Call event handler, treating handler without result as one which
+ * returned true.
+ *
+ * @param fn Lambda calling handler
+ * @return Result of handler
+ */
+constexpr bool invoke(auto&& fn)
+{
+    if constexpr (std::is_void_v<decltype(fn())>) {
+        fn();
+        return true;
+    } else {
+        return fn();
+    }
+}
+
+}
+
+/**
+ * @brief Walk CBOR sequence once, pushing events into visitor. Every handler
+ * is optional, and values of items without handler are never decoded, only
+ * skipped. Handlers (V is visitor instance):
+ * [ v.on_uint(uint64_t), v.on_sint(int64_t), v.on_float(double), v.on_prim(prim) ]
+ * [ v.on_data(span), v.on_text(dec::txt), v.on_tag(uint64_t)                    ]
+ * [ v.on_array_begin(size_t), v.on_array_end(), v.on_map_begin(size_t)           ]
+ * [ v.on_map_end(), v.on_data_begin(), v.on_data_end(), v.on_text_begin()        ]
+ * [ v.on_text_end()                                                              ]
+ * Size passed to begin handlers is size_t(-1) for indefinite containers, definite
+ * ones with such count are rejected with err_invalid_length. Content
+ * of tag is reported right after on_tag(). Chunks of indefinite strings are
+ * reported with on_data() or on_text() between begin and end events. Begin
+ * handlers may return bool, if false is returned, content is skipped without
+ * events, including end event.
+ *
+ * @tparam Depth Maximum nesting depth
+ * @param p Begin pointer, must be valid pointer
+ * @param end End pointer, must be valid pointer
+ * @param v Visitor
+ * @return Tuple with error status and pointer past last character interpreted
+ */
+template<size_t Depth = 16, class V>
+constexpr std::tuple<err, pointer> parse(pointer p, const pointer end, V&& v)
+{
+    constexpr auto indef = uint64_t(-1);
+
+    struct {
+        uint64_t left;
+        type_t type;
+    } stack[Depth]{};
+    size_t lvl = 0;
+    uint64_t val;
+    err e;
+
+    // Count completed item in enclosing containers, close exhausted ones
+    auto complete = [&] {
+        while (lvl && stack[lvl - 1].left != indef) {
+            if (--stack[lvl - 1].left)
+                break;
+            switch (stack[--lvl].type)
+            {
+            case type_array:
+                if constexpr (requires { v.on_array_end(); })
+                    v.on_array_end();
+            break;
+            case type_map:
+                if constexpr (requires { v.on_map_end(); })
+                    v.on_map_end();
+            break;
+            default:;
+            }
+        }
+    };
+    // Open container or skip its content, if visitor refused to enter
+    auto open = [&](bool enter, uint64_t left, type_t type) -> err {
+        if (!enter) {
+            std::tie(e, p) = dec::skip(p, end, left == indef ? 0 : left, left == indef);
+            if (e != err_ok)
+                return e;
+            complete();
+        } else if (left) {
+            if (lvl == Depth)
+                return err_no_memory;
+            stack[lvl++] = {left, type};
+        }
+        return err_ok;
+    };
+
+    while (p < end || lvl) {
+
+        if (p >= end)
+            return {err_out_of_bounds, end};
+
+        byte ib = *p++;
+        auto& h = dec::heads[ib];
+
+        if (lvl && (stack[lvl - 1].type == type_indef_data ||
+                    stack[lvl - 1].type == type_indef_text)) {
+            if (ib != 0xff && (stack[lvl - 1].type != h.type + 7 || !(h.flags & dec::head_string)))
+                return {err_invalid_indef_string, p};
+        }
+        if (h.flags & dec::head_special) {
+            switch (h.flags)
+            {
+            case dec::head_break:
+                if (!lvl || stack[lvl - 1].left != indef)
+                    return {err_invalid_break, p};
+                switch (stack[--lvl].type)
+                {
+                case type_array:
+                    if constexpr (requires { v.on_array_end(); })
+                        v.on_array_end();
+                break;
+                case type_map:
+                    if constexpr (requires { v.on_map_end(); })
+                        v.on_map_end();
+                break;
+                case type_indef_data:
+                    if constexpr (requires { v.on_data_end(); })
+                        v.on_data_end();
+                break;
+                default:
+                    if constexpr (requires { v.on_text_end(); })
+                        v.on_text_end();
+                }
+                complete();
+            break;
+            case dec::head_indef: {
+                bool enter = true;
+                switch (h.type)
+                {
+                case type_array:
+                    if constexpr (requires { v.on_array_begin(size_t(indef)); })
+                        enter = sax::invoke([&] { return v.on_array_begin(size_t(indef)); });
+                break;
+                case type_map:
+                    if constexpr (requires { v.on_map_begin(size_t(indef)); })
+                        enter = sax::invoke([&] { return v.on_map_begin(size_t(indef)); });
+                break;
+                case type_indef_data:
+                    if constexpr (requires { v.on_data_begin(); })
+                        enter = sax::invoke([&] { return v.on_data_begin(); });
+                break;
+                default:
+                    if constexpr (requires { v.on_text_begin(); })
+                        enter = sax::invoke([&] { return v.on_text_begin(); });
+                }
+                if (!enter && (h.type == type_indef_data || h.type == type_indef_text)) {
+                    std::tie(e, p) = dec::skip_istr(type_t(h.type), p, end);
+                    if (e != err_ok)
+                        return {e, p};
+                    complete();
+                } else if ((e = open(enter, indef, type_t(h.type))) != err_ok) {
+                    return {e, p};
+                }
+            }
+            break;
+            case dec::head_reserved: return {err_reserved_ai, p};
+            default: return {err_invalid_indef_mt, p};
+            }
+            continue;
+        }
+
+        if (h.len > end - p)
+            return {err_out_of_bounds, p};
+
+        val = dec::arg(ib, h.len, p, end);
+        p += h.len;
+
+        switch (h.type)
+        {
+        case type_uint:
+            if constexpr (requires { v.on_uint(val); })
+                v.on_uint(val);
+        break;
+        case type_sint:
+            if constexpr (requires { v.on_sint(int64_t(~val)); })
+                v.on_sint(int64_t(~val));
+        break;
+        case type_data:
+            if (val > uint64_t(end - p))
+                return {err_out_of_bounds, p};
+            if constexpr (requires { v.on_data(span{p, size_t(val)}); })
+                v.on_data(span{p, size_t(val)});
+            p += val;
+        break;
+        case type_text:
+            if (val > uint64_t(end - p))
+                return {err_out_of_bounds, p};
+            if constexpr (requires { v.on_text(dec::txt{p, size_t(val)}); })
+                v.on_text(dec::txt{p, size_t(val)});
+            p += val;
+        break;
+        case type_array: {
+            if (val >= size_t(-1))
+                return {err_invalid_length, p};
+            bool enter = true;
+            if constexpr (requires { v.on_array_begin(size_t(val)); })
+                enter = sax::invoke([&] { return v.on_array_begin(size_t(val)); });
+            if (enter && !val) {
+                if constexpr (requires { v.on_array_end(); })
+                    v.on_array_end();
+            }
+            if ((e = open(enter, val, type_array)) != err_ok)
+                return {e, p};
+            if (!enter || val)
+                continue;
+        }
+        break;
+        case type_map: {
+            if (val >= size_t(-1))
+                return {err_invalid_length, p};
+            bool enter = true;
+            if constexpr (requires { v.on_map_begin(size_t(val)); })
+                enter = sax::invoke([&] { return v.on_map_begin(size_t(val)); });
+            if (enter && !val) {
+                if constexpr (requires { v.on_map_end(); })
+                    v.on_map_end();
+            }
+            if ((e = open(enter, std::min(val, indef >> 1) << 1, type_map)) != err_ok)
+                return {e, p};
+            if (!enter || val)
+                continue;
+        }
+        break;
+        case type_tag:
+            if constexpr (requires { v.on_tag(val); })
+                v.on_tag(val);
+            if ((e = open(true, 1, type_tag)) != err_ok)
+                return {e, p};
+        continue;
+        case type_floating:
+            if constexpr (requires { v.on_float(double{}); }) {
+                switch (h.len)
+                {
+                case 2: v.on_float(std::bit_cast<float>(utl::half_to_float(val))); break;
+                case 4: v.on_float(std::bit_cast<float>(uint32_t(val))); break;
+                default: v.on_float(std::bit_cast<double>(val)); break;
+                }
+            }
+        break;
+        default:
+            if constexpr (requires { v.on_prim(prim(val)); })
+                v.on_prim(prim(val));
+        }
+        complete();
+    }
+    return {err_ok, p};
+}
+
+/**
+ * @brief Same as zbor::parse(), but for whole sequence.
+ *
+ * @tparam Depth Maximum nesting depth
+ * @param s Sequence
+ * @param v Visitor
+ * @return Tuple with error status and pointer past last character interpreted
+ */
+template<size_t Depth = 16, class V>
+constexpr std::tuple<err, pointer> parse(seq s, V&& v)
+{
+    return parse<Depth>(s.data(), s.data() + s.size(), v);
+}
+
+}
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef ZBOR_STREAM_H
+#define ZBOR_STREAM_H
+
+#include "zbor/enc.h"
+
+namespace zbor {
+namespace stream {
+
+/**
+ * @brief Open container of stream_decoder.
+ *
+ */
+struct level {
+    uint64_t left;  // Number of nested items left, stream::indef if closed by break
+    type_t type;    // Container type
+};
+
+constexpr auto indef = uint64_t(-1);
+
+}
+
+/**
+ * @brief Resumable decoder for input arriving in chunks, e.g. from socket.
+ * Chunks are appended with feed() into fixed window provided by user, and
+ * next() emits items one by one as soon as they are complete, keeping
+ * nesting state between calls. Containers and tags are emitted as heads
+ * only (with empty range), followed by their nested items one level deeper,
+ * so memory is bounded by window size rather than by message size. Only
+ * definite strings must fit entirely into window.
+ *
+ * @tparam Depth Maximum nesting depth
+ */
+template<size_t Depth = 16>
+struct stream_decoder {
+    constexpr stream_decoder() = delete;
+    constexpr stream_decoder(std::span<byte> buf) : buf{buf} {}
+
+    /**
+     * @brief Append chunk of input to window, discarding bytes consumed by
+     * previous calls to next(), which invalidates all emitted items.
+     *
+     * @param chunk Input bytes
+     * @return Number of bytes accepted, less than chunk size if window is full
+     */
+    constexpr size_t feed(span chunk)
+    {
+        if (pos) {
+            std::copy(buf.begin() + pos, buf.begin() + len, buf.begin());
+            len -= pos;
+            pos = 0;
+        }
+        size_t n = std::min(chunk.size(), buf.size() - len);
+        std::copy_n(chunk.begin(), n, buf.begin() + len);
+        len += n;
+        return n;
+    }
+
+    /**
+     * @brief Decode next complete item from window. Breaks of indefinite
+     * containers are consumed silently, end of container can be detected
+     * by depth() of the following item. Emitted item points into window
+     * and stays valid until next call to feed().
+     *
+     * @return Tuple with decoded item and error status: err_out_of_bounds
+     * if more input is needed, err_no_memory if item doesn't fit into
+     * window or nesting exceeds Depth, other errors for malformed input
+     */
+    constexpr std::tuple<item, err> next()
+    {
+        while (pos < len && buf[pos] == 0xff) {
+            if (!lvl || stack[lvl - 1].left != stream::indef)
+                return {item{}, err_invalid_break};
+            ++pos;
+            --lvl;
+            complete();
+        }
+        if (pos >= len)
+            return {item{}, err_out_of_bounds};
+
+        const pointer p     = buf.data() + pos;
+        const pointer end   = buf.data() + len;
+
+        if (lvl && (stack[lvl - 1].type == type_indef_data ||
+                    stack[lvl - 1].type == type_indef_text)) {
+            if (stack[lvl - 1].type != ((*p & 0xe0) >> 5) + 7 || (*p & 0x1f) == ai_indef)
+                return {item{}, err_invalid_indef_string};
+        }
+        auto [obj, e, q] = dec::decode(p, end, true);
+
+        if (e == err_out_of_bounds && !pos && len == buf.size())
+            return {item{}, err_no_memory};
+        if (e != err_ok)
+            return {item{}, e};
+
+        uint64_t left = 0;
+
+        switch (obj.type)
+        {
+        case type_array:
+            left = obj.arr.size();
+            obj.arr = {q, q, obj.arr.size(), true};
+        break;
+        case type_map:
+            left = obj.map.indef() ? stream::indef : std::min<uint64_t>(obj.map.size(), stream::indef >> 1) << 1;
+            obj.map = {q, q, obj.map.size(), true};
+        break;
+        case type_tag:
+            left = 1;
+            obj.tag = {q, q, obj.tag.num(), true};
+        break;
+        case type_indef_data:
+        case type_indef_text:
+            left = stream::indef;
+            obj.istr = {q, q};
+        break;
+        default:;
+        }
+        if (left && lvl == Depth)
+            return {item{}, err_no_memory};
+
+        at = lvl;
+        pos = q - buf.data();
+
+        if (left)
+            stack[lvl++] = {left, obj.type};
+        else
+            complete();
+
+        return {obj, err_ok};
+    }
+
+    /**
+     * @brief Restart decoding, discarding window content and nesting state.
+     *
+     */
+    constexpr void reset()
+    {
+        pos = len = lvl = at = 0;
+    }
+
+    constexpr size_t depth() const      { return at; }
+    constexpr size_t open() const       { return lvl; }
+    constexpr size_t buffered() const   { return len - pos; }
+    constexpr size_t capacity() const   { return buf.size(); }
+    constexpr bool idle() const         { return !lvl && pos == len; }
+private:
+    /**
+     * @brief Count completed item in enclosing containers, closing
+     * every definite container which has no items left.
+     *
+     */
+    constexpr void complete()
+    {
+        while (lvl && stack[lvl - 1].left != stream::indef) {
+            if (--stack[lvl - 1].left)
+                break;
+            --lvl;
+        }
+    }
+
+    std::span<byte> buf;
+    size_t pos = 0;
+    size_t len = 0;
+    size_t lvl = 0;
+    size_t at = 0;
+    stream::level stack[Depth]{};
+};
+
+/**
+ * @brief CBOR encoder over fixed window provided by user, which passes 
+ * encoded output to sink whenever window fills up, so documents of any 
+ * size are produced in O(window) memory. Payload of strings of at least 
+ * half of window is passed to sink directly, without copying. Sink is 
+ * called as sink(span) and returns err_ok on success. Call flush() after 
+ * last item. Since output leaves window, deferred length handles and 
+ * iteration over codec apply only to not yet flushed content: end() of 
+ * handle which head was flushed fails with err_no_memory.
+ * 
+ * @tparam Sink Callable which consumes output, e.g. writes it to socket
+ */
+template<class Sink>
+struct stream_encoder : enc::interface<stream_encoder<Sink>> {
+    friend enc::interface<stream_encoder<Sink>>;
+    constexpr stream_encoder() = delete;
+    constexpr stream_encoder(std::span<byte> buf, Sink sink) : max{buf.size()}, buf{buf.data()}, sink{sink} {}
+
+    /**
+     * @brief Pass content of window to sink and empty it.
+     * 
+     * @return Error status of sink
+     */
+    constexpr err flush()
+    {
+        if (!idx)
+            return err_ok;
+        err e = sink(span{buf, idx});
+        if (e != err_ok)
+            return e;
+        out += idx;
+        idx = 0;
+        return err_ok;
+    }
+    constexpr size_t flushed() const    { return out; }
+    constexpr err status() const        { return last; }
+private:
+    constexpr bool grow(size_t len)
+    {
+        len -= idx;
+        last = flush();
+        return last == err_ok && len <= max;
+    }
+    constexpr bool accepts(size_t len) const
+    {
+        return len && len >= max / 2;
+    }
+    constexpr err refer(pointer data, size_t len)
+    {
+        if ((last = flush()) != err_ok)
+            return last;
+        if ((last = sink(span{data, len})) != err_ok)
+            return last;
+        out += len;
+        return err_ok;
+    }
+
+    size_t idx = 0;
+    const size_t max;
+    byte* const buf;
+    Sink sink;
+    size_t out = 0;     // Number of bytes passed to sink
+    err last = err_ok;  // Last error of sink
+};
+
+}
+
+#endif
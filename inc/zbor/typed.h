@@ -0,0 +1,212 @@
+#ifndef ZBOR_TYPED_H
+#define ZBOR_TYPED_H
+
+#include "zbor/enc.h"
+
+namespace zbor {
+namespace typed {
+
+/**
+ * @brief Element format of RFC 8746 typed array, encoded in tag number
+ * 0b010fsell: f - floating point, s - signed, e - little endian, ll -
+ * log2 of size (float16 is ll = 0). Tag 68 is uint8 with clamped
+ * arithmetic, tag 76 is reserved.
+ *
+ */
+struct format {
+    byte size = 0;          // Element size in bytes, zero if tag isn't typed array
+    bool floating = false;
+    bool sign = false;
+    std::endian order = std::endian::big;
+    constexpr bool valid() const { return size; }
+};
+
+/**
+ * @brief Format of elements by tag number.
+ *
+ * @param tag Tag number
+ * @return Element format, invalid if tag isn't typed array
+ */
+constexpr format parse(uint64_t tag)
+{
+    if (tag < 64 || tag > 87 || tag == 76)
+        return {};
+    byte ll = tag & 3;
+    bool f = tag & 16;
+    return {
+        byte(f ? 2 << ll : 1 << ll), f, !f && (tag & 8),
+        tag & 4 ? std::endian::little : std::endian::big
+    };
+}
+
+/**
+ * @brief Tag number of typed array of T.
+ *
+ * @tparam T Integer, float or double
+ * @param order Byte order of elements
+ * @return Tag number
+ */
+template<enc::number T>
+constexpr uint64_t tag(std::endian order = std::endian::native)
+{
+    uint64_t ll = std::countr_zero(sizeof(T));
+    uint64_t e = sizeof(T) > 1 && order == std::endian::little ? 4 : 0;
+    if constexpr (std::is_floating_point_v<T>)
+        return 80 + e + ll - 1;
+    else
+        return 64 + (std::is_signed_v<T> ? 8 : 0) + e + ll;
+}
+
+/**
+ * @brief Check if elements of given format can be stored in T, only float16
+ * is converted into wider floating point type.
+ *
+ * @param f Element format
+ * @return True if match
+ */
+template<enc::number T>
+constexpr bool matches(format f)
+{
+    if constexpr (std::is_floating_point_v<T>)
+        return f.floating && (f.size == sizeof(T) || f.size == 2);
+    else
+        return !f.floating && f.sign == std::is_signed_v<T> && f.size == sizeof(T);
+}
+
+/**
+ * @brief Load element in given byte order.
+ *
+ * @param p Element bytes
+ * @param order Byte order
+ * @return Element bits
+ */
+template<class U>
+constexpr U load(pointer p, std::endian order)
+{
+    U u = utl::load_be<U>(p);
+    return order == std::endian::little ? utl::byteswap(u) : u;
+}
+
+/**
+ * @brief Content of typed array of T.
+ *
+ * @param obj Decoded item
+ * @return Element format and payload, invalid format if item isn't typed array of T
+ */
+template<enc::number T>
+constexpr std::tuple<format, span> content(const item& obj)
+{
+    if (obj.type != type_tag)
+        return {};
+    auto f = parse(obj.tag.num());
+    if (!matches<T>(f))
+        return {};
+    auto data = obj.tag.content();
+    if (data.type != type_data || data.data.size() % f.size)
+        return {};
+    return {f, data.data};
+}
+
+}
+
+/**
+ * @brief Encode RFC 8746 typed array: tag of element type in native byte
+ * order and elements as byte string, so there is no per-element work and
+ * zbor::gather_view references elements instead of copying.
+ *
+ * @param codec Any codec
+ * @param val Contiguous range of integers, floats or doubles
+ * @return Error status
+ */
+template<class C, std::ranges::contiguous_range R>
+    requires enc::number<std::ranges::range_value_t<R>>
+err encode_typed(enc::interface<C>& codec, const R& val)
+{
+    using T = std::ranges::range_value_t<R>;
+    err e = codec.encode_tag(typed::tag<T>());
+    if (e != err_ok)
+        return e;
+    return codec.encode_data(span(reinterpret_cast<pointer>(std::ranges::data(val)), std::ranges::size(val) * sizeof(T)));
+}
+
+/**
+ * @brief View typed array of T directly over input. Possible only if elements
+ * are in native byte order (or have single byte) and payload is aligned for T,
+ * otherwise use typed_copy().
+ *
+ * @param obj Decoded item
+ * @return Elements and error status, err_invalid_type if item isn't viewable
+ * typed array of T
+ */
+template<enc::number T>
+std::tuple<std::span<const T>, err> typed_view(const item& obj)
+{
+    auto [f, data] = typed::content<T>(obj);
+
+    if (f.size != sizeof(T) || (sizeof(T) > 1 && f.order != std::endian::native))
+        return {std::span<const T>{}, err_invalid_type};
+    if (reinterpret_cast<uintptr_t>(data.data()) % alignof(T))
+        return {std::span<const T>{}, err_invalid_type};
+
+    return {std::span{reinterpret_cast<const T*>(data.data()), data.size() / sizeof(T)}, err_ok};
+}
+
+/**
+ * @brief Copy elements of typed array of T in any byte order and alignment,
+ * float16 elements are converted into T.
+ *
+ * @param obj Decoded item
+ * @param out Output elements
+ * @return Number of elements of array and error status, err_invalid_type if
+ * item isn't typed array of T, err_no_memory if output has less elements
+ */
+template<enc::number T>
+constexpr std::tuple<size_t, err> typed_copy(const item& obj, std::span<T> out)
+{
+    auto [f, data] = typed::content<T>(obj);
+
+    if (!f.valid())
+        return {0, err_invalid_type};
+
+    size_t n = data.size() / f.size;
+
+    if (n > out.size())
+        return {n, err_no_memory};
+
+    auto p = data.data();
+
+    if constexpr (std::is_floating_point_v<T>) {
+        if (f.size == 2) {
+            // Converted in chunks with utl::half_to_float_n()
+            uint16_t h[64];
+            float tmp[64];
+            for (size_t i = 0; i < n; i += 64) {
+                size_t m = std::min<size_t>(64, n - i);
+                for (size_t k = 0; k < m; ++k, p += 2)
+                    h[k] = typed::load<uint16_t>(p, f.order);
+                if constexpr (std::is_same_v<T, float>) {
+                    utl::half_to_float_n(h, &out[i], m);
+                } else {
+                    utl::half_to_float_n(h, tmp, m);
+                    std::copy_n(tmp, m, &out[i]);
+                }
+            }
+            return {n, err_ok};
+        }
+    }
+    for (size_t i = 0; i < n; ++i, p += f.size) {
+        if constexpr (std::is_floating_point_v<T>) {
+            if constexpr (sizeof(T) == 4)
+                out[i] = std::bit_cast<T>(typed::load<uint32_t>(p, f.order));
+            else
+                out[i] = std::bit_cast<T>(typed::load<uint64_t>(p, f.order));
+        } else {
+            out[i] = T(typed::load<std::make_unsigned_t<T>>(p, f.order));
+        }
+    }
+    return {n, err_ok};
+}
+
+}
+
+#endif
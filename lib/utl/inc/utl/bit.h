@@ -3,6 +3,8 @@
 
 #include "utl/base.h"
 #include <bit>
+#include <cstring>
+#include <type_traits>
 
 namespace utl {
 
@@ -104,6 +106,51 @@ constexpr unsigned cnttz(auto x)
         return std::countr_zero(x);
 }
 
+/**
+ * @brief Reverse order of bytes, same as std::byteswap from C++23.
+ * 
+ * @tparam T Unsigned integer type
+ * @param x Integer
+ * @return Integer with reversed bytes
+ */
+template<class T>
+constexpr T byteswap(T x)
+{
+    if constexpr (sizeof(T) == 1)
+        return x;
+    else if constexpr (sizeof(T) == 2)
+        return __builtin_bswap16(x);
+    else if constexpr (sizeof(T) == 4)
+        return __builtin_bswap32(x);
+    else
+        return __builtin_bswap64(x);
+}
+
+/**
+ * @brief Load big-endian integer from possibly unaligned memory. At 
+ * runtime it's a single load followed by byte swap on little-endian 
+ * machines, byte by byte assembly is used only in constant evaluation.
+ * 
+ * @tparam T Unsigned integer type
+ * @param p Pointer to at least sizeof(T) bytes
+ * @return Loaded integer
+ */
+template<class T>
+constexpr T load_be(const uint8_t* p)
+{
+    if (std::is_constant_evaluated()) {
+        T x = 0;
+        for (size_t i = 0; i < sizeof(T); ++i)
+            x = T(x << 8) | p[i];
+        return x;
+    }
+    T x;
+    memcpy(&x, p, sizeof(T));
+    if constexpr (std::endian::native == std::endian::little)
+        x = byteswap(x);
+    return x;
+}
+
 /**
  * @brief Get number of words (integers) required to store N bits.
  * 
@@ -2,6 +2,9 @@
 #define UTL_FLOAT_H
 
 #include "utl/bit.h"
+#if defined(__F16C__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 
 namespace utl {
 namespace imp {
@@ -189,6 +192,72 @@ constexpr uint64_t half_to_double(uint16_t h)
     return std::bit_cast<uint64_t>(d);
 }
 
+/**
+ * @brief Convert array of single precision values to half precision. With 
+ * AVX-512 or F16C enabled, 16 or 8 values are converted at once by vcvtps2ph, 
+ * which rounds to nearest even, otherwise (and in constant evaluation) 
+ * float_to_half() is used. Results are identical for values representable 
+ * in half precision, inexact values may differ in last bit, since scalar 
+ * code rounds ties away from zero and truncates subnormal results.
+ * 
+ * @param in Single precision values
+ * @param out Half precision values stored as uint16_t
+ * @param n Number of values
+ */
+constexpr void float_to_half_n(const float* in, uint16_t* out, size_t n)
+{
+    size_t i = 0;
+
+    if (!std::is_constant_evaluated()) {
+#if defined(__AVX512F__)
+        for (; i + 16 <= n; i += 16) {
+            // Zero-masked form, plain one passes undefined source which GCC reports as uninitialized
+            __m256i h = _mm512_maskz_cvtps_ph(0xffff, _mm512_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), h);
+        }
+#endif
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8) {
+            __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+        }
+#endif
+    }
+    for (; i < n; ++i)
+        out[i] = float_to_half(std::bit_cast<uint32_t>(in[i]));
+}
+
+/**
+ * @brief Convert array of half precision values to single precision, with 
+ * AVX-512 or F16C by vcvtph2ps, otherwise with half_to_float(). Conversion 
+ * is exact, only signaling NaN is quieted by vcvtph2ps.
+ * 
+ * @param in Half precision values stored as uint16_t
+ * @param out Single precision values
+ * @param n Number of values
+ */
+constexpr void half_to_float_n(const uint16_t* in, float* out, size_t n)
+{
+    size_t i = 0;
+
+    if (!std::is_constant_evaluated()) {
+#if defined(__AVX512F__)
+        for (; i + 16 <= n; i += 16) {
+            __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            _mm512_storeu_ps(out + i, _mm512_maskz_cvtph_ps(0xffff, h));
+        }
+#endif
+#if defined(__F16C__)
+        for (; i + 8 <= n; i += 8) {
+            __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+        }
+#endif
+    }
+    for (; i < n; ++i)
+        out[i] = std::bit_cast<float>(half_to_float(in[i]));
+}
+
 }
 
 #endif
\ No newline at end of file
@@ -127,6 +127,34 @@ TEST(Bit, CountTrailingZeros)
     ASSERT_EQ(cnttz(0x54fe413f), 0);
 }
 
+TEST(Bit, ByteSwap)
+{
+    static_assert(byteswap(uint8_t(0x12)) == 0x12);
+    static_assert(byteswap(uint16_t(0x1234)) == 0x3412);
+    static_assert(byteswap(uint32_t(0x12345678)) == 0x78563412);
+    static_assert(byteswap(uint64_t(0x0123456789abcdef)) == 0xefcdab8967452301);
+
+    ASSERT_EQ(byteswap(uint8_t(0x12)), 0x12);
+    ASSERT_EQ(byteswap(uint16_t(0x1234)), 0x3412);
+    ASSERT_EQ(byteswap(uint32_t(0x12345678)), 0x78563412);
+    ASSERT_EQ(byteswap(uint64_t(0x0123456789abcdef)), 0xefcdab8967452301);
+}
+
+TEST(Bit, LoadBigEndian)
+{
+    static constexpr uint8_t test[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+
+    static_assert(load_be<uint8_t>(test + 1) == 0x01);
+    static_assert(load_be<uint16_t>(test + 1) == 0x0102);
+    static_assert(load_be<uint32_t>(test + 1) == 0x01020304);
+    static_assert(load_be<uint64_t>(test + 1) == 0x0102030405060708);
+
+    ASSERT_EQ(load_be<uint8_t>(test + 1), 0x01);
+    ASSERT_EQ(load_be<uint16_t>(test + 1), 0x0102);
+    ASSERT_EQ(load_be<uint32_t>(test + 1), 0x01020304);
+    ASSERT_EQ(load_be<uint64_t>(test + 1), 0x0102030405060708);
+}
+
 TEST(Bit, WordsIntBits)
 {
     auto wib8 = [](size_t x) {return words_in_bits<uint8_t>(x);};
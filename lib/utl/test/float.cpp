@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "utl/float.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace utl;
+
+TEST(Float, HalfToFloatN)
+{
+    std::vector<uint16_t> in(0x10000 + 5);
+    std::vector<float> out(in.size());
+
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = uint16_t(i);
+
+    half_to_float_n(in.data(), out.data(), in.size());
+
+    for (size_t i = 0; i < in.size(); ++i) {
+        float ref = std::bit_cast<float>(half_to_float(in[i]));
+        if (std::isnan(ref))
+            ASSERT_TRUE(std::isnan(out[i])) << i;
+        else
+            ASSERT_EQ(std::bit_cast<uint32_t>(out[i]), std::bit_cast<uint32_t>(ref)) << i;
+    }
+}
+
+TEST(Float, FloatToHalfN)
+{
+    // Every finite and infinite half, as single
+    std::vector<float> in;
+    for (uint32_t h = 0; h < 0x10000; ++h) {
+        if ((h & 0x7c00) != 0x7c00 || !(h & 0x3ff))
+            in.push_back(std::bit_cast<float>(half_to_float(h)));
+    }
+    std::vector<uint16_t> out(in.size());
+
+    float_to_half_n(in.data(), out.data(), in.size());
+
+    for (size_t i = 0; i < in.size(); ++i)
+        ASSERT_EQ(out[i], float_to_half(std::bit_cast<uint32_t>(in[i]))) << in[i];
+
+    // Inexact values with normal result, rounding differs only for ties
+    std::mt19937 rng{1};
+    in.clear();
+    for (int i = 0; i < 10000; ++i)
+        in.push_back(std::ldexp(1.0f + float(rng() >> 8) / 0x1000000, int(rng() % 29) - 14) * (i % 2 ? 1 : -1));
+    in.push_back(65519.0f);
+    in.push_back(65520.0f);
+    in.push_back(1e10f);
+    out.resize(in.size());
+
+    float_to_half_n(in.data(), out.data(), in.size());
+
+    for (size_t i = 0; i < in.size(); ++i) {
+        uint32_t f = std::bit_cast<uint32_t>(in[i]);
+        if ((f & 0x1fff) != 0x1000) {
+            ASSERT_EQ(out[i], float_to_half(f)) << in[i];
+        }
+    }
+
+    constexpr auto h = [] {
+        const float f[] = {1.0f, -2.0f, 0.5f};
+        uint16_t h[3]{};
+        float_to_half_n(f, h, 3);
+        return h[1];
+    }();
+    static_assert(h == 0xc000);
+}
@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include "zbor/compact.h"
+#include "zbor/enc.h"
+#include <vector>
+
+using namespace zbor;
+
+namespace {
+
+/**
+ * @brief Compare compact item with regular item of the same object.
+ *
+ */
+void same(const compact::seq& doc, const compact::item& c, const item& r)
+{
+    ASSERT_EQ(c.type, r.type);
+    switch (r.type)
+    {
+    case type_uint: ASSERT_EQ(c.uint(), r.uint); break;
+    case type_sint: ASSERT_EQ(c.sint(), r.sint); break;
+    case type_data: ASSERT_EQ(c.data().data(), r.data.data()); ASSERT_EQ(c.data().size(), r.data.size()); break;
+    case type_text: ASSERT_EQ(c.text(), r.text); break;
+    case type_floating: ASSERT_TRUE(c.fp() == r.fp || (std::isnan(c.fp()) && std::isnan(r.fp))); break;
+    case type_prim: ASSERT_EQ(c.prim(), r.prim); break;
+    case type_tag:
+        ASSERT_EQ(c.num(), r.tag.num());
+        same(doc, doc.content(c), r.tag.content());
+    break;
+    case type_array: {
+        ASSERT_EQ(c.size(), r.arr.size());
+        auto it = r.arr.begin();
+        for (auto v : doc.arr(c)) {
+            ASSERT_TRUE(it != r.arr.end());
+            same(doc, v, *it++);
+        }
+        ASSERT_FALSE(it != r.arr.end());
+    }
+    break;
+    case type_map: {
+        ASSERT_EQ(c.size(), r.map.size());
+        auto it = r.map.begin();
+        for (auto [k, v] : doc.map(c)) {
+            ASSERT_TRUE(it != r.map.end());
+            same(doc, k, (*it).first);
+            same(doc, v, (*it).second);
+            ++it;
+        }
+        ASSERT_FALSE(it != r.map.end());
+    }
+    break;
+    default: {
+        auto it = r.istr.begin();
+        for (auto v : doc.arr(c))
+            same(doc, v, *it++);
+        ASSERT_FALSE(it != r.istr.end());
+    }
+    }
+}
+
+}
+
+TEST(Compact, Size)
+{
+    static_assert(sizeof(compact::item) == 16);
+    static_assert(sizeof(compact::seq_iter) == 24);
+    static_assert(sizeof(compact::map_iter) == 24);
+}
+
+TEST(Compact, Traverse)
+{
+    using namespace std::literals;
+
+    std::vector<byte> buf(1024);
+    view c{buf};
+
+    c.encode_(enc::map(4),
+        "big"sv, enc::arr(6), uint64_t(1) << 40, int64_t(-5000000000), 1.5f, 0.1f, 0.1, "text"sv,
+        1, enc::tag(1), uint64_t(1700000000),
+        enc::arr(2), true, prim_null,
+        "nested"sv, "m"sv, enc::map(1), enc::arr(1), 2, span{buf.data(), 3});
+    c.encode_(enc::indef_arr(), 1, enc::indef_map(), "a"sv, 2, enc::breaker(), enc::breaker());
+    c.encode_(enc::indef_txt(), "ab"sv, "c"sv, enc::breaker());
+    c.encode_(enc::arr(24));
+    for (int i = 0; i < 24; ++i)
+        c.encode(i - 12);
+
+    compact::seq doc{buf.data(), c.size()};
+    auto it = seq{buf.data(), c.size()}.begin();
+    size_t n = 0;
+
+    for (auto obj : doc) {
+        same(doc, obj, *it);
+        same(doc, obj, doc.expand(obj));
+        ++it;
+        ++n;
+    }
+    ASSERT_EQ(n, 4);
+    ASSERT_FALSE(it != seq{}.end());
+    auto end = doc.begin();
+    while (end != doc.end())
+        ++end;
+    ASSERT_EQ(end.error(), err_ok);
+
+    // Lookup in map, including non-scalar key
+    std::vector<byte> keys(64);
+    view k{keys};
+    k.encode_(enc::map(3), enc::arr(1), 1, 10, "x"sv, 20, 7, 30);
+    compact::seq kd{keys.data(), k.size()};
+    int64_t sum = 0;
+    for (auto [key, val] : kd.map(*kd.begin()))
+        sum += val.uint();
+    ASSERT_EQ(sum, 60);
+}
+
+TEST(Compact, Malformed)
+{
+    // Traversal stops at truncated or reserved head, like regular one
+    const byte test_1[] = {0x01, 0x02, 0x19, 0x01};
+    const byte test_2[] = {0x83, 0x01, 0x1c, 0x03};
+    const byte test_3[] = {0xa2, 0x01, 0x02, 0x03};
+
+    size_t n = 0;
+    for (auto obj : compact::seq{test_1})
+        n += obj.valid();
+    ASSERT_EQ(n, 2);
+
+    compact::seq doc{test_2};
+    n = 0;
+    for (auto obj : doc.arr(*doc.begin()))
+        n += obj.uint();
+    ASSERT_EQ(n, 1);
+
+    compact::seq map{test_3};
+    n = 0;
+    for (auto [key, val] : map.map(*map.begin()))
+        n += key.uint() + val.uint();
+    ASSERT_EQ(n, 3);
+
+    ASSERT_FALSE(compact::head(test_1 + 2, std::end(test_1)).valid());
+    ASSERT_FALSE(doc.arr(compact::head(test_1, std::end(test_1))).begin() != compact::seq_iter{});
+
+    // Definite count of indefinite length, unlike the one right below
+    const byte test_4[] = {0x9b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    const byte test_5[] = {0x9b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe};
+    const byte test_6[] = {0x9f, 0xff};
+    ASSERT_FALSE(compact::head(std::begin(test_4), std::end(test_4)).valid());
+    ASSERT_EQ(compact::head(std::begin(test_5), std::end(test_5)).size(), uint64_t(-2));
+    ASSERT_EQ(compact::head(std::begin(test_6), std::end(test_6)).size(), uint64_t(-1));
+
+    // Oversized chunk of indefinite string
+    const byte test_7[] = {0x5f, 0x5b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf7, 0xff, 0x01};
+    n = 0;
+    for (auto obj : compact::seq{test_7})
+        n += obj.valid();
+    ASSERT_EQ(n, 1);
+
+    // Error which stopped traversal
+    auto error = [](auto it) {
+        while (it != decltype(it){})
+            ++it;
+        return it.error();
+    };
+    const byte test_8[] = {0x82, 0x01, 0xff};
+    const byte test_9[] = {0xbf, 0x01, 0xff};
+    const byte test_10[] = {0x9f, 0x01, 0xff, 0x01};
+    compact::seq arr{test_8};
+    compact::seq indef{test_9};
+    compact::seq ok{test_10};
+    ASSERT_EQ(error(compact::seq{test_1}.begin()), err_out_of_bounds);
+    ASSERT_EQ(error(doc.arr(*doc.begin()).begin()), err_reserved_ai);
+    ASSERT_EQ(error(map.map(*map.begin()).begin()), err_out_of_bounds);
+    ASSERT_EQ(error(compact::seq{test_7}.begin()), err_out_of_bounds);
+    ASSERT_EQ(error(arr.arr(*arr.begin()).begin()), err_invalid_break);
+    ASSERT_EQ(error(indef.map(*indef.begin()).begin()), err_invalid_break);
+    ASSERT_EQ(error(ok.arr(*ok.begin()).begin()), err_ok);
+    ASSERT_EQ(error(ok.begin()), err_ok);
+}
+
+TEST(Compact, Constexpr)
+{
+    static constexpr byte test[] = {0x83, 0x01, 0x1b, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x63, 0x61, 0x62, 0x63};
+    constexpr auto sum = [] {
+        compact::seq doc{test};
+        uint64_t s = 0;
+        for (auto v : doc.arr(*doc.begin()))
+            s += v.type == type_text ? v.text().size() : v.uint();
+        return s;
+    }();
+    static_assert(sum == 1 + (uint64_t(1) << 40) + 3);
+}
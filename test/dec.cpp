@@ -720,6 +720,58 @@ TEST(Decode, IndefText)
     ASSERT_EQ(p, end);
 }
 
+TEST(Decode, IndefChunks)
+{
+    const byte test_1[] = {
+        0x7f, 0x65, 0x73, 0x74, 0x72, 0x65, 0x61, 0x60, 0x64, 0x6d, 0x69, 0x6e, 0x67, 0xff, // (_ "strea", "", "ming")
+    };
+    const byte test_2[] = {
+        0x5f, 0x42, 0x01, 0x02, 0x43, 0x03, 0x04, 0x05, 0x62, 0x06, 0x07, 0xff, // (_ h'0102', h'030405', "\x06\x07") - mixed chunks
+    };
+
+    for (bool lazy : {false, true}) {
+        auto [o, e, p] = dec::decode(test_1, std::end(test_1), lazy);
+        ASSERT_EQ(e, err_ok);
+        ASSERT_EQ(o.type, type_indef_text);
+
+        std::string str;
+        size_t n = 0;
+        for (auto c : o.istr.chunks()) {
+            str.append(c.begin(), c.end());
+            ++n;
+        }
+        ASSERT_EQ(n, 3);
+        ASSERT_EQ(str, "streaming");
+        ASSERT_EQ(o.istr.total_size(), 9);
+
+        byte out[9];
+        ASSERT_EQ(o.istr.copy_to(out), std::make_tuple(size_t(9), err_ok));
+        ASSERT_EQ(dec::txt(out, 9), "streaming");
+
+        byte small[4] = {};
+        ASSERT_EQ(o.istr.copy_to(small), std::make_tuple(size_t(9), err_no_memory));
+        ASSERT_EQ(dec::txt(small, 4), "stre");
+    }
+
+    // Lazily decoded string isn't checked, chunks stop at first mismatching one
+    auto [o, e, p] = decode_lazy(test_2, std::end(test_2));
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(o.istr.total_size(), 5);
+    ASSERT_EQ(std::get<err>(decode(test_2, std::end(test_2))), err_invalid_indef_string);
+
+    // Truncated chunk
+    ASSERT_EQ(dec::istr(test_1 + 1, 4).total_size(), 0);
+    ASSERT_FALSE(dec::istr{}.chunks().begin() != dec::istr{}.chunks().end());
+
+    static constexpr byte test_3[] = {0x5f, 0x41, 0x01, 0x58, 0x02, 0x02, 0x03, 0xff};
+    constexpr auto copy = [] {
+        std::array<byte, 3> out{};
+        std::get<item>(decode(test_3, test_3 + sizeof(test_3))).istr.copy_to(out);
+        return out;
+    }();
+    static_assert(copy == std::array<byte, 3>{1, 2, 3});
+}
+
 TEST(Decode, IndefArray)
 {
     const byte test[] = {
@@ -839,6 +891,242 @@ TEST(Decode, Mixed)
     ASSERT_EQ(p, end);
 }
 
+TEST(Decode, Lazy)
+{
+    const byte test[] = {
+        0x83, 0x01, 0x82, 0x02, 0x03, 0x9f, 0x04, 0x05, 0xff, // [1, [2, 3], [_ 4, 5]]
+        0xa2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x82, 0x02, 0x03, // {"a": 1, "b": [2, 3]}
+        0xc1, 0x82, 0x01, 0x02, // 1([1, 2])
+        0x7f, 0x65, 0x73, 0x74, 0x72, 0x65, 0x61, 0x64, 0x6d, 0x69, 0x6e, 0x67, 0xff, // (_ "strea", "ming")
+    };
+
+    item o;
+    err e;
+    auto p = test;
+    auto end = test + sizeof(test);
+
+    std::tie(o, e, p) = decode_lazy(p, end);
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(p, test + 1);
+    ASSERT_EQ(o.type, type_array);
+    ASSERT_EQ(o.arr.size(), 3);
+    ASSERT_EQ(o.arr.lazy(), true);
+
+    uint64_t sum = 0;
+    auto itr = o.arr.begin();
+
+    ASSERT_EQ((*itr).type, type_uint);
+    ASSERT_EQ((*itr).uint, 1);
+    ++itr;
+    ASSERT_EQ((*itr).type, type_array);
+    ASSERT_EQ((*itr).arr.size(), 2);
+    for (auto it : (*itr).arr)
+        sum += it.uint;
+    ++itr;
+    ASSERT_EQ((*itr).type, type_array);
+    ASSERT_EQ((*itr).arr.indef(), true);
+    for (auto it : (*itr).arr)
+        sum += it.uint;
+    ++itr;
+    ASSERT_EQ(itr != o.arr.end(), false);
+    ASSERT_EQ(itr.pos(), test + 9);
+    ASSERT_EQ(sum, 14);
+
+    std::tie(o, e, p) = decode_lazy(itr.pos(), end);
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(p, test + 10);
+    ASSERT_EQ(o.type, type_map);
+    ASSERT_EQ(o.map.size(), 2);
+
+    auto map_itr = o.map.begin();
+
+    ASSERT_EQ((*map_itr).first.text, "a");
+    ASSERT_EQ((*map_itr).second.uint, 1);
+    ++map_itr;
+    ASSERT_EQ((*map_itr).first.text, "b");
+    ASSERT_EQ((*map_itr).second.type, type_array);
+    ASSERT_EQ((*map_itr).second.arr.size(), 2);
+    ++map_itr;
+    ASSERT_EQ(map_itr != o.map.end(), false);
+    ASSERT_EQ(map_itr.pos(), test + 18);
+
+    std::tie(o, e, p) = decode_lazy(map_itr.pos(), end);
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(p, test + 19);
+    ASSERT_EQ(o.type, type_tag);
+    ASSERT_EQ(o.tag.num(), 1);
+    ASSERT_EQ(o.tag.content().type, type_array);
+    ASSERT_EQ(o.tag.content().arr.size(), 2);
+    ASSERT_EQ(o.tag.content().arr.lazy(), true);
+
+    std::tie(o, e, p) = decode(p, end);
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(p, test + 22);
+    ASSERT_EQ(o.type, type_array);
+
+    std::tie(o, e, p) = decode_lazy(p, end);
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(p, test + 23);
+    ASSERT_EQ(o.type, type_indef_text);
+
+    int chunks = 0;
+    for ([[maybe_unused]] auto it : o.istr)
+        ++chunks;
+    ASSERT_EQ(chunks, 2);
+}
+
+TEST(Decode, LazyResume)
+{
+    const byte test[] = {
+        0x83, 0x82, 0x01, 0x02, 0x9f, 0x03, 0xff, 0x04, // [[1, 2], [_ 3], 4]
+    };
+
+    auto [o, e, p] = decode_lazy(test, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(o.type, type_array);
+
+    uint64_t sum = 0;
+    auto itr = o.arr.begin();
+
+    while (itr != o.arr.end()) {
+        if ((*itr).type == type_array) {
+            auto nested = (*itr).arr.begin();
+            for (; nested != (*itr).arr.end(); ++nested)
+                sum += (*nested).uint;
+            itr.resume(nested.pos());
+        } else {
+            sum += (*itr).uint;
+        }
+        ++itr;
+    }
+    ASSERT_EQ(sum, 10);
+    ASSERT_EQ(itr.pos(), test + sizeof(test));
+}
+
+TEST(Decode, LazyDeferredErrors)
+{
+    const byte test[] = {
+        0x82, 0x01, 0x1c, // [1, <reserved ai>]
+    };
+
+    auto [o, e, p] = decode_lazy(test, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(p, test + 1);
+    ASSERT_EQ(o.type, type_array);
+
+    int cnt = 0;
+    for ([[maybe_unused]] auto it : o.arr)
+        ++cnt;
+    ASSERT_EQ(cnt, 1);
+
+    std::tie(o, e, p) = decode(test, test + sizeof(test));
+
+    ASSERT_EQ(e, err_reserved_ai);
+    ASSERT_EQ(o.type, type_invalid);
+}
+
+TEST(Decode, MapFind)
+{
+    const byte test[] = {
+        0xa4, // {
+            0x61, 0x61, 0x01, // "a": 1
+            0x61, 0x62, 0x82, 0x02, 0x03, // "b": [2, 3]
+            0x18, 0x2a, 0x63, 0x66, 0x6f, 0x6f, // 42: "foo"
+            0x20, 0xf5, // -1: true
+        // }
+        0xbf, 0x01, 0x02, 0x61, 0x61, 0x9f, 0xff, 0x03, 0x04, 0xff, // {_ 1: 2, "a": [_ ], 3: 4}
+    };
+
+    auto [o, e, p] = decode(test, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(o.type, type_map);
+
+    ASSERT_EQ(o.map.find("a").type, type_uint);
+    ASSERT_EQ(o.map.find("a").uint, 1);
+    ASSERT_EQ(o.map["b"].type, type_array);
+    ASSERT_EQ(o.map["b"].arr.size(), 2);
+    ASSERT_EQ(o.map[42].text, "foo");
+    ASSERT_EQ(o.map[42u].text, "foo");
+    ASSERT_EQ(o.map[uint64_t(42)].text, "foo");
+    ASSERT_EQ(o.map[-1].type, type_prim);
+    ASSERT_EQ(o.map[int64_t(-1)].prim, prim_true);
+    ASSERT_EQ(o.map["c"].valid(), false);
+    ASSERT_EQ(o.map[1].valid(), false);
+    ASSERT_EQ(o.map[-2].valid(), false);
+
+    auto found = o.map.find_if([](const item& k) { return k.type == type_sint; });
+
+    ASSERT_EQ(found.type, type_prim);
+
+    std::tie(o, e, p) = decode_lazy(p, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(o.type, type_map);
+    ASSERT_EQ(o.map.indef(), true);
+
+    ASSERT_EQ(o.map[1].uint, 2);
+    ASSERT_EQ(o.map["a"].type, type_array);
+    ASSERT_EQ(o.map["a"].arr.lazy(), true);
+    ASSERT_EQ(o.map[3].uint, 4);
+    ASSERT_EQ(o.map[4].valid(), false);
+
+    static constexpr byte ce_test[] = { 0xa2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x02 }; // {"a": 1, "b": 2}
+    static constexpr auto ce_val = std::get<item>(decode(ce_test, ce_test + sizeof(ce_test))).map["b"].uint;
+    static_assert(ce_val == 2);
+}
+
+TEST(Decode, ArrayAt)
+{
+    const byte test[] = {
+        0x84, 0x01, 0x82, 0x02, 0x03, 0x61, 0x61, 0x18, 0x2a, // [1, [2, 3], "a", 42]
+        0x9f, 0x01, 0x9f, 0xff, 0x02, 0xff, // [_ 1, [_ ], 2]
+    };
+
+    auto [o, e, p] = decode(test, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(o.arr.at(0).uint, 1);
+    ASSERT_EQ(o.arr.at(1).arr.size(), 2);
+    ASSERT_EQ(o.arr[2].text, "a");
+    ASSERT_EQ(o.arr[3].uint, 42);
+    ASSERT_EQ(o.arr[4].valid(), false);
+
+    std::tie(o, e, p) = decode_lazy(p, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(o.arr[0].uint, 1);
+    ASSERT_EQ(o.arr[1].type, type_array);
+    ASSERT_EQ(o.arr[2].uint, 2);
+    ASSERT_EQ(o.arr[3].valid(), false);
+    ASSERT_EQ(o.arr[4].valid(), false);
+
+    static constexpr byte ce_test[] = { 0x83, 0x01, 0x02, 0x03 };
+    static_assert(std::get<item>(decode(ce_test, ce_test + sizeof(ce_test))).arr[2].uint == 3);
+}
+
+TEST(Decode, MapAt)
+{
+    const byte test[] = { 0xa2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x02 }; // {"a": 1, "b": 2}
+
+    auto [o, e, p] = decode(test, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(o.map.size(), 2);
+    ASSERT_EQ(o.map.at(0).text, "a");
+    ASSERT_EQ(o.map.at(1).uint, 1);
+    ASSERT_EQ(o.map.at(2).text, "b");
+    ASSERT_EQ(o.map.at(3).uint, 2);
+    ASSERT_EQ(o.map.at(4).valid(), false);
+}
+
 TEST(Decode, Constexpr)
 {
     static constexpr const uint8_t test[] = { 
@@ -925,6 +1213,20 @@ TEST(Decode, Constexpr)
         return i;
     }();
     static_assert(73 == cnt);
+
+    static constexpr auto lazy_cnt = [&]()
+    {
+        int i = 0;
+        auto p = test;
+        while (p < test + sizeof(test)) {
+            auto itr = seq_iter{p, test + sizeof(test), 1, true};
+            ++itr;
+            p = itr.pos();
+            ++i;
+        }
+        return i;
+    }();
+    static_assert(73 == lazy_cnt);
 }
 
 TEST(Decode, ErrorOutOfBounds)
@@ -969,7 +1271,7 @@ TEST(Decode, ErrorOutOfBounds)
     std::tie(o, e, p) = decode(test_5.begin(), test_5.end());
 
     ASSERT_EQ(e, err_out_of_bounds);
-    ASSERT_EQ(p, test_5.begin() + 4);
+    ASSERT_EQ(p, test_5.begin() + 2);
     ASSERT_EQ(o.type, type_invalid);
 
     std::tie(o, e, p) = decode(test_6.begin(), test_6.end());
@@ -989,6 +1291,22 @@ TEST(Decode, ErrorOutOfBounds)
     ASSERT_EQ(e, err_out_of_bounds);
     ASSERT_EQ(p, test_8.begin() + 2);
     ASSERT_EQ(o.type, type_invalid);
+
+    // Chunk length which would wrap pointer back to chunk head
+    std::array<byte, 11> test_9 = { 0x5f, 0x5b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf7, 0xff };
+
+    std::tie(o, e, p) = decode(test_9.begin(), test_9.end());
+
+    ASSERT_EQ(e, err_out_of_bounds);
+    ASSERT_EQ(p, test_9.begin() + 10);
+    ASSERT_EQ(o.type, type_invalid);
+    ASSERT_EQ(std::get<0>(dec::skip_istr(type_indef_data, test_9.begin() + 1, test_9.end())), err_out_of_bounds);
+
+    auto [lazy, le, lp] = decode_lazy(test_9.begin(), test_9.end());
+    ASSERT_EQ(le, err_ok);
+    size_t n = 0;
+    for (auto it = lazy.istr.begin(); it != lazy.istr.end(); ++it)
+        ASSERT_LT(++n, 2);
 }
 
 TEST(Decode, ErrorReservedAi)
@@ -1100,4 +1418,285 @@ TEST(Decode, ErrorInvalidIndefString)
     ASSERT_EQ(e, err_invalid_indef_string);
     ASSERT_EQ(p, test.begin() + 3);
     ASSERT_EQ(o.type, type_invalid);
-}
\ No newline at end of file
+}
+
+TEST(Decode, ErrorInvalidLength)
+{
+    // Definite counts right below and at indefinite length
+    const byte arr_max[] = { 0x9b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe, 0x01 };
+    const byte arr_bad[] = { 0x9b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01 };
+    const byte map_bad[] = { 0xbb, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01 };
+
+    auto [o, e, p] = decode_lazy(std::begin(arr_max), std::end(arr_max));
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(o.arr.size(), size_t(-2));
+    ASSERT_EQ(o.arr.indef(), false);
+    ASSERT_EQ(std::get<err>(decode(std::begin(arr_max), std::end(arr_max))), err_out_of_bounds);
+
+    std::tie(o, e, p) = decode_lazy(std::begin(arr_bad), std::end(arr_bad));
+    ASSERT_EQ(e, err_invalid_length);
+    ASSERT_EQ(p, arr_bad + 9);
+    ASSERT_EQ(o.type, type_invalid);
+    ASSERT_EQ(std::get<err>(decode(std::begin(arr_bad), std::end(arr_bad))), err_invalid_length);
+    ASSERT_EQ(std::get<err>(decode_lazy(std::begin(map_bad), std::end(map_bad))), err_invalid_length);
+}
+
+TEST(Decode, HeadTable)
+{
+    // Same heads at the end of input (bytewise read) and followed by padding (wide read)
+    std::array<byte, 3> test_1 = { 0x19, 0x01, 0x2c };
+    std::array<byte, 12> test_2 = { 0x19, 0x01, 0x2c, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    std::array<byte, 9> test_3 = { 0x3b, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+    std::array<byte, 12> test_4 = { 0x3b, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0, 0, 0 };
+    std::array<byte, 10> test_5 = { 0x82, 0x63, 0x61, 0x62, 0x63, 0xa1, 0x01, 0x1a, 0x00, 0x01 };
+
+    auto [o1, e1, p1] = decode(test_1.begin(), test_1.end());
+    auto [o2, e2, p2] = decode(test_2.begin(), test_2.end());
+
+    ASSERT_EQ(e1, err_ok);
+    ASSERT_EQ(e2, err_ok);
+    ASSERT_EQ(o1.uint, 300);
+    ASSERT_EQ(o2.uint, 300);
+    ASSERT_EQ(p1, test_1.end());
+    ASSERT_EQ(p2, test_2.begin() + 3);
+
+    auto [o3, e3, p3] = decode(test_3.begin(), test_3.end());
+    auto [o4, e4, p4] = decode(test_4.begin(), test_4.end());
+
+    ASSERT_EQ(e3, err_ok);
+    ASSERT_EQ(e4, err_ok);
+    ASSERT_EQ(o3.sint, ~int64_t(0x0102030405060708));
+    ASSERT_EQ(o4.sint, ~int64_t(0x0102030405060708));
+
+    // Truncated 4-byte argument inside map
+    auto [o5, e5, p5] = decode(test_5.begin(), test_5.end());
+
+    ASSERT_EQ(e5, err_out_of_bounds);
+    ASSERT_EQ(o5.type, type_invalid);
+
+    for (int i = 0; i < 256; ++i) {
+        auto& h = dec::heads[i];
+        byte ai = i & 0x1f;
+        if (!(h.flags & dec::head_slow)) {
+            ASSERT_EQ(h.len, 0);
+            ASSERT_LT(ai, ai_1);
+        }
+        if (ai >= ai_1 && ai <= ai_8) {
+            ASSERT_EQ(h.len, 1 << (ai - ai_1));
+        }
+    }
+}
+
+TEST(Decode, SkipScalars)
+{
+    for (int i = 0; i < 256; ++i) {
+        byte b = i;
+        bool scalar = b <= 0x17 || (b >= 0x20 && b <= 0x37) || (b >= 0xe0 && b <= 0xf7);
+        ASSERT_EQ(dec::scalars(&b, &b + 1), scalar) << i;
+    }
+
+    // Runs across vector widths, interrupted at every position
+    std::array<byte, 80> run;
+    for (size_t i = 0; i < run.size(); ++i) {
+        run.fill(0xf5);
+        run[i] = 0x18;
+        ASSERT_EQ(dec::scalars(run.begin(), run.end()), i);
+        ASSERT_EQ(dec::scalars(run.begin(), run.begin() + i), i);
+    }
+
+    // Large array of small integers, followed by another item
+    std::array<byte, 46> test_1;
+    test_1.fill(0x21);
+    test_1[0] = 0x98;
+    test_1[1] = 40;
+    test_1[42] = 0x19;
+    test_1[43] = 0x01;
+    test_1[44] = 0x2c;
+    test_1[45] = 0xf6;
+
+    auto [e1, p1] = dec::skip(test_1.begin(), test_1.end(), 1, 0);
+    ASSERT_EQ(e1, err_ok);
+    ASSERT_EQ(p1, test_1.begin() + 42);
+
+    auto [e2, p2] = dec::skip(test_1.begin() + 2, test_1.end(), 17, 0);
+    ASSERT_EQ(e2, err_ok);
+    ASSERT_EQ(p2, test_1.begin() + 19);
+
+    // Indefinite array of simple values, run stops at break
+    std::array<byte, 41> test_2;
+    test_2.fill(0xf4);
+    test_2[0] = 0x9f;
+    test_2[39] = 0xff;
+    test_2[40] = 0x00;
+
+    auto [o3, e3, p3] = decode(test_2.begin(), test_2.end());
+    ASSERT_EQ(e3, err_ok);
+    ASSERT_EQ(o3.type, type_array);
+    ASSERT_EQ(p3, test_2.begin() + 40);
+
+    // Array claims more items than available
+    auto [o4, e4, p4] = decode(test_1.begin(), test_1.begin() + 30);
+    ASSERT_EQ(e4, err_out_of_bounds);
+}
+
+TEST(Decode, Validate)
+{
+    auto check = [](std::initializer_list<byte> in, err exp, size_t off, limits lim = {}) {
+        std::vector<byte> buf(in);
+        auto [e, o] = validate(buf, lim);
+        EXPECT_EQ(e, exp) << str_err(e);
+        EXPECT_EQ(o, off);
+    };
+
+    // Well-formed
+    check({0x00}, err_ok, 1);
+    check({0x1b, 1, 2, 3, 4, 5, 6, 7, 8}, err_ok, 9);
+    check({0x80}, err_ok, 1);
+    check({0x83, 0x01, 0x82, 0x02, 0x03, 0x82, 0x04, 0x05}, err_ok, 8);
+    check({0xa2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x82, 0x02, 0x03}, err_ok, 9);
+    check({0x9f, 0x01, 0x82, 0x02, 0x03, 0x9f, 0xff, 0xff}, err_ok, 8);
+    check({0xbf, 0x61, 0x61, 0x01, 0x61, 0x62, 0x9f, 0x02, 0xff, 0xff}, err_ok, 10);
+    check({0x5f, 0x42, 0x01, 0x02, 0x41, 0x03, 0xff}, err_ok, 7);
+    check({0x7f, 0x60, 0x61, 0x61, 0xff}, err_ok, 5);
+    check({0xc1, 0xc2, 0x41, 0x00}, err_ok, 4);
+    check({0xd8, 0x64, 0x00}, err_ok, 3);
+    check({0xf8, 0x20}, err_ok, 2);
+    check({0xfb, 0x3f, 0xf1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9a}, err_ok, 9);
+
+    // Malformed, offset of offending item
+    check({}, err_out_of_bounds, 0);
+    check({0x83, 0x01, 0x02}, err_out_of_bounds, 3);
+    check({0x9f, 0x82, 0x01, 0xff}, err_invalid_break, 3);
+    check({0xbf, 0x01, 0xff}, err_invalid_break, 2);
+    check({0x5f, 0x01, 0xff}, err_invalid_indef_string, 1);
+    check({0x5f, 0x5f, 0xff, 0xff}, err_invalid_indef_string, 1);
+    check({0x7f, 0x41, 0x00, 0xff}, err_invalid_indef_string, 1);
+    check({0xff}, err_invalid_break, 0);
+    check({0x82, 0x01, 0x1c}, err_reserved_ai, 2);
+    check({0x82, 0x01, 0x3f}, err_invalid_indef_mt, 2);
+    check({0xf8, 0x10}, err_invalid_simple, 0);
+    check({0x81, 0x5a, 0xff, 0xff, 0xff, 0xff}, err_out_of_bounds, 1);
+    check({0x01, 0x02}, err_trailing_bytes, 1);
+    check({0x82, 0x01, 0x02, 0x03}, err_trailing_bytes, 3);
+
+    // Header claiming huge number of entries is rejected right away
+    check({0xbb, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00}, err_out_of_bounds, 0);
+
+    // Limits
+    check({0x81, 0x81, 0x80}, err_ok, 3, {.depth = 2});
+    check({0x81, 0x81, 0x81, 0x00}, err_limit_exceeded, 2, {.depth = 2});
+    check({0x9f, 0x9f, 0x9f, 0xff, 0xff, 0xff}, err_limit_exceeded, 2, {.depth = 2});
+    check({0xc1, 0xc1, 0xc1, 0x00}, err_limit_exceeded, 2, {.depth = 2});
+    check({0x83, 0x01, 0x02, 0x03}, err_ok, 4, {.items = 4});
+    check({0x83, 0x01, 0x02, 0x03}, err_limit_exceeded, 3, {.items = 3});
+
+    std::vector<byte> deep(1000, 0x81);
+    deep.push_back(0x00);
+    ASSERT_EQ(std::get<err>(validate(deep, {.depth = 10000})), err_limit_exceeded);
+
+    // Run of scalars in large array, limited by array and total items
+    std::vector<byte> run(42, 0x21);
+    run[0] = 0x98;
+    run[1] = 40;
+    ASSERT_EQ(validate(run), std::tuple(err_ok, run.size()));
+    ASSERT_EQ(validate(run, {.items = 30}), std::tuple(err_limit_exceeded, 31));
+    run.push_back(0x00);
+    ASSERT_EQ(validate(run), std::tuple(err_trailing_bytes, 42));
+
+    // Valid input is decoded without error, both agree on mutated input 
+    // except checks which are performed by validate() only
+    std::vector<byte> msg = {
+        0xa3, 0x61, 0x61, 0x9f, 0x01, 0x20, 0xf9, 0x3c, 0x00, 0xff, 0x61, 0x62, 0x5f, 0x41, 
+        0x01, 0xff, 0x61, 0x63, 0xc1, 0x98, 0x14, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14,
+    };
+    ASSERT_EQ(validate(msg), std::tuple(err_ok, msg.size()));
+
+    for (size_t i = 0; i < msg.size(); ++i) {
+        for (int b = 0; b < 256; ++b) {
+            auto mut = msg;
+            mut[i] = b;
+            auto [e, o] = validate(mut);
+            if (e == err_ok) {
+                auto [obj, de, p] = decode(mut.data(), mut.data() + mut.size());
+                ASSERT_EQ(de, err_ok) << i << " " << b;
+                ASSERT_EQ(p, mut.data() + mut.size()) << i << " " << b;
+            }
+        }
+    }
+
+    static constexpr byte ce[] = {0x82, 0x01, 0x9f, 0xff};
+    static_assert(validate(ce) == std::tuple(err_ok, 4));
+}
+
+TEST(Decode, Limits)
+{
+    auto check = [](std::initializer_list<byte> in, err exp, limits lim) {
+        std::vector<byte> buf(in);
+        auto [o, e, p] = decode(buf.data(), buf.data() + buf.size(), lim);
+        EXPECT_EQ(e, exp) << str_err(e);
+        EXPECT_EQ(std::get<err>(validate(buf, lim)), exp);
+        EXPECT_EQ(o.valid(), exp == err_ok);
+    };
+
+    // Strings and chunks
+    check({0x43, 0x01, 0x02, 0x03}, err_ok, {.string = 3});
+    check({0x43, 0x01, 0x02, 0x03}, err_limit_exceeded, {.string = 2});
+    check({0x82, 0x41, 0x01, 0x58, 0x03, 0x01, 0x02, 0x03}, err_limit_exceeded, {.string = 2});
+    check({0x7f, 0x61, 0x61, 0x63, 0x61, 0x62, 0x63, 0xff}, err_limit_exceeded, {.string = 2});
+
+    // Containers, map length counts pairs
+    check({0x83, 0x01, 0x02, 0x03}, err_limit_exceeded, {.length = 2});
+    check({0xa2, 0x01, 0x02, 0x03, 0x04}, err_ok, {.length = 2});
+    check({0x81, 0xa3, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06}, err_limit_exceeded, {.length = 2});
+    check({0x9f, 0x98, 0x03, 0x01, 0x02, 0x03, 0xff}, err_limit_exceeded, {.length = 2});
+
+    // Depth and total items
+    check({0xc1, 0x81, 0x00}, err_ok, {.depth = 2});
+    check({0xc1, 0x81, 0x81, 0x00}, err_limit_exceeded, {.depth = 2});
+    check({0x81, 0x00}, err_limit_exceeded, {.depth = 0});
+    check({0x80}, err_ok, {.depth = 0});
+    check({0x82, 0x01, 0x02}, err_ok, {.items = 3});
+    check({0x82, 0x01, 0x02}, err_limit_exceeded, {.items = 2});
+    check({0x01}, err_limit_exceeded, {.items = 0});
+
+    // Deeply nested indefinite arrays are well-formed, but rejected at limit
+    std::vector<byte> deep(2000, 0x9f);
+    std::fill(deep.begin() + 1000, deep.end(), 0xff);
+    auto [o1, e1, p1] = decode(deep.data(), deep.data() + deep.size());
+    ASSERT_EQ(e1, err_ok);
+    auto [o2, e2, p2] = decode(deep.data(), deep.data() + deep.size(), limits{});
+    ASSERT_EQ(e2, err_limit_exceeded);
+    ASSERT_EQ(p2, deep.data() + 64);
+
+    // Map header claiming 2^63 pairs, doubled count used to wrap to zero
+    const byte huge[] = {0xbb, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02};
+    ASSERT_EQ(std::get<err>(decode(std::begin(huge), std::end(huge))), err_out_of_bounds);
+    ASSERT_EQ(std::get<err>(decode(std::begin(huge), std::end(huge), limits{})), err_out_of_bounds);
+    ASSERT_EQ(std::get<err>(decode(std::begin(huge), std::end(huge), limits{.length = 1000})), err_limit_exceeded);
+    ASSERT_EQ(std::get<0>(dec::skip(std::begin(huge), std::end(huge), 1, 0)), err_out_of_bounds);
+
+    // Lazy decoding checks only head
+    const byte nested[] = {0x81, 0x83, 0x01, 0x02, 0x03};
+    ASSERT_EQ(std::get<err>(decode_lazy(std::begin(nested), std::end(nested), limits{.length = 2})), err_ok);
+    ASSERT_EQ(std::get<err>(decode_lazy(std::begin(nested), std::end(nested), limits{.depth = 0})), err_limit_exceeded);
+
+    // Limited decoding agrees with validate() on mutated input
+    std::vector<byte> msg = {
+        0xa3, 0x61, 0x61, 0x9f, 0x01, 0x20, 0xf9, 0x3c, 0x00, 0xff, 0x61, 0x62, 0x5f, 0x41, 
+        0x01, 0xff, 0x61, 0x63, 0xc1, 0x98, 0x14, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14,
+    };
+    for (size_t i = 0; i < msg.size(); ++i) {
+        for (int b = 0; b < 256; ++b) {
+            auto mut = msg;
+            mut[i] = b;
+            auto [e, o] = validate(mut);
+            auto [obj, de, p] = decode(mut.data(), mut.data() + mut.size(), limits{});
+            if (de == err_ok)
+                ASSERT_EQ(e, p == mut.data() + mut.size() ? err_ok : err_trailing_bytes) << i << " " << b;
+            else
+                ASSERT_EQ(e, de) << i << " " << b;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include "zbor/dynamic.h"
+
+using namespace zbor;
+
+namespace {
+
+/**
+ * @brief Allocator which counts allocations.
+ *
+ */
+template<class T>
+struct counting {
+    using value_type = T;
+    size_t* count;
+    T* allocate(size_t n)               { ++*count; return std::allocator<T>{}.allocate(n); }
+    void deallocate(T* p, size_t n)     { std::allocator<T>{}.deallocate(p, n); }
+    bool operator==(const counting&) const = default;
+};
+
+}
+
+TEST(DynamicCodec, Grow)
+{
+    dynamic_codec codec;
+
+    ASSERT_EQ(codec.capacity(), 0);
+    ASSERT_EQ(codec.size(), 0);
+
+    for (uint64_t i = 0; i < 1000; ++i)
+        ASSERT_EQ(codec.encode_(i, "text"), err_ok);
+
+    ASSERT_GE(codec.capacity(), codec.size());
+
+    size_t i = 0;
+    for (auto it : codec) {
+        if (i % 2 == 0)
+            ASSERT_EQ(it.uint, i / 2);
+        else
+            ASSERT_EQ(it.text, "text");
+        ++i;
+    }
+    ASSERT_EQ(i, 2000);
+
+    // Large string which exceeds doubled capacity
+    std::vector<byte> blob(codec.capacity() * 3, 0xab);
+    ASSERT_EQ(codec.encode_data(blob), err_ok);
+    ASSERT_GE(codec.capacity(), codec.size());
+    ASSERT_EQ(codec[codec.size() - 1], 0xab);
+
+    auto moved = std::move(codec);
+    ASSERT_EQ(codec.size(), 0);
+    ASSERT_EQ(codec.capacity(), 0);
+    ASSERT_EQ(moved[codec.size()], 0x00);
+}
+
+TEST(DynamicCodec, Allocator)
+{
+    size_t count = 0;
+    {
+        dynamic_codec<counting<byte>> codec{counting<byte>{&count}};
+
+        for (int i = 0; i < 10000; ++i)
+            codec.encode_uint(i);
+
+        // Geometric growth
+        ASSERT_LE(count, 12);
+    }
+    count = 0;
+    {
+        dynamic_codec<counting<byte>> codec{4096, counting<byte>{&count}};
+        ASSERT_EQ(count, 1);
+        ASSERT_TRUE(codec.reserve(100));
+        ASSERT_EQ(count, 1);
+
+        for (int i = 0; i < 1000; ++i)
+            codec.encode_uint(i);
+
+        ASSERT_EQ(count, 1);
+    }
+
+    // Arena
+    byte arena[1024];
+    std::pmr::monotonic_buffer_resource res{arena, sizeof(arena), std::pmr::null_memory_resource()};
+    dynamic_codec<std::pmr::polymorphic_allocator<byte>> codec{&res};
+
+    ASSERT_EQ(codec.encode_(1, 2, 3), err_ok);
+    ASSERT_GE(codec.data(), arena);
+    ASSERT_LT(codec.data(), arena + sizeof(arena));
+
+    // Move assignment between arenas copies content, within arena takes storage
+    byte other_arena[1024];
+    std::pmr::monotonic_buffer_resource other_res{other_arena, sizeof(other_arena), std::pmr::null_memory_resource()};
+    dynamic_codec<std::pmr::polymorphic_allocator<byte>> other{&other_res};
+
+    ASSERT_EQ(other.encode_(4, 5), err_ok);
+    other = std::move(codec);
+    ASSERT_EQ(other.size(), 3);
+    ASSERT_EQ(other[2], 3);
+    ASSERT_GE(other.data(), other_arena);
+    ASSERT_LT(other.data(), other_arena + sizeof(other_arena));
+    ASSERT_EQ(other.get_allocator().resource(), &other_res);
+    ASSERT_EQ(codec.size(), 0);
+    ASSERT_EQ(codec.capacity(), 0);
+
+    dynamic_codec<std::pmr::polymorphic_allocator<byte>> same{&other_res};
+    auto data = other.data();
+    same = std::move(other);
+    ASSERT_EQ(same.data(), data);
+    ASSERT_EQ(same.size(), 3);
+}
+
+TEST(DynamicCodec, Constexpr)
+{
+    constexpr auto size = [] {
+        dynamic_codec codec;
+        for (int i = 0; i < 100; ++i)
+            codec.encode_uint(1000);
+        return codec.size();
+    }();
+    static_assert(size == 300);
+}
@@ -153,6 +153,55 @@ TEST_F(Encode, ExplicitFloating)
     });
 }
 
+TEST_F(Encode, FixedFloating)
+{
+    codec.encode_float32(1.0f);
+    codec.encode_float64(1.0);
+    codec.encode_(zbor::enc::f32{-4.0f}, zbor::enc::f64{0.0});
+    codec.encode_float32(NAN);
+
+    check(codec, {
+        0xfa, 0x3f, 0x80, 0x00, 0x00, // 1.0
+        0xfb, 0x3f, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 1.0
+        0xfa, 0xc0, 0x80, 0x00, 0x00, // -4.0
+        0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0.0
+        0xfa, 0x7f, 0xc0, 0x00, 0x00, // NaN
+    });
+}
+
+TEST_F(Encode, ShortestFloating)
+{
+    // Bit tests against round trip conversion, over sampled bit patterns
+    for (uint64_t i = 0; i < 0x100000000; i += 997) {
+        uint32_t f = uint32_t(i);
+        float v = std::bit_cast<float>(f);
+        uint16_t h = utl::float_to_half(f);
+        bool exact = v == std::bit_cast<float>(utl::half_to_float(h));
+
+        ASSERT_EQ(zbor::enc::fits_half(f), exact || v != v) << std::hex << f;
+        if (exact) {
+            ASSERT_EQ(zbor::enc::half_bits(f), h) << std::hex << f;
+        }
+    }
+    // Every half precision value
+    for (uint32_t h = 0; h < 0x10000; ++h) {
+        uint32_t f = utl::half_to_float(h);
+        ASSERT_TRUE(zbor::enc::fits_half(f)) << std::hex << h;
+        uint16_t exp = (h & 0x7fff) <= 0x7c00 ? h : 0x7e00;
+        ASSERT_EQ(zbor::enc::half_bits(f), exp) << std::hex << h;
+    }
+    for (uint64_t i = 0; i < 0x1000000; ++i) {
+        // Low and high bits of mantissa, all exponents and signs
+        uint64_t d = (i & 0xfff) << 52 | (i >> 12 & 0x3f) << 46 | (i >> 18);
+        double v = std::bit_cast<double>(d);
+        ASSERT_EQ(zbor::enc::fits_float(d), v == double(float(v)) || v != v) << std::hex << d;
+    }
+    static_assert(zbor::enc::fits_float(std::bit_cast<uint64_t>(0x1p-149)));
+    static_assert(!zbor::enc::fits_float(std::bit_cast<uint64_t>(0x1p-150)));
+    static_assert(!zbor::enc::fits_float(std::bit_cast<uint64_t>(0x1.000001p-126)));
+    static_assert(zbor::enc::half_bits(std::bit_cast<uint32_t>(-0x1p-24f)) == 0x8001);
+}
+
 TEST_F(Encode, ImplicitFloating)
 {
     codec.encode(0.0);
@@ -988,4 +1037,179 @@ TEST_F(Encode, View)
         0x16,
         0xf4,
     });
-}
\ No newline at end of file
+}
+
+TEST_F(Encode, Deferred)
+{
+    using namespace std::literals;
+
+    // Fits reserved immediate head
+    auto arr = codec.begin_arr();
+    codec.encode_(1, 2, 3);
+    ASSERT_EQ(arr.end(), zbor::err_ok);
+
+    // Nested, map with one pair, reserved 1-byte argument kept
+    auto map = codec.begin_map(200);
+    codec.encode("a"sv);
+    auto nested = codec.begin_arr();
+    ASSERT_EQ(nested.end(), zbor::err_ok);
+    ASSERT_EQ(map.end(), zbor::err_ok);
+
+    check(codec, {
+        0x83, 0x01, 0x02, 0x03,
+        0xb8, 0x01, 0x61, 0x61, 0x80,
+    });
+    codec.clear();
+
+    // Exceeds reserved width, content is shifted
+    auto wide = codec.begin_arr();
+    for (int i = 0; i < 30; ++i)
+        codec.encode(i % 2 ? 1000 : 1);
+    ASSERT_EQ(wide.end(), zbor::err_ok);
+
+    ASSERT_EQ(codec.size(), 2 + 15 * 3 + 15);
+    ASSERT_EQ(codec[0], 0x98);
+    ASSERT_EQ(codec[1], 30);
+    ASSERT_EQ(codec[2], 0x01);
+    ASSERT_EQ(codec[3], 0x19);
+
+    auto [obj, e, p] = zbor::decode(codec.data(), codec.data() + codec.size());
+    ASSERT_EQ(e, zbor::err_ok);
+    ASSERT_EQ(obj.arr.size(), 30);
+    codec.clear();
+
+    // Count given by caller
+    auto given = codec.begin_arr(1000);
+    codec.encode_(1, 2);
+    ASSERT_EQ(given.end(2), zbor::err_ok);
+    check(codec, { 0x99, 0x00, 0x02, 0x01, 0x02 });
+    codec.clear();
+
+    // Not enough memory to widen head
+    auto full = codec.begin_arr();
+    while (codec.size() < codec.capacity())
+        codec.encode(0);
+    ASSERT_EQ(full.end(), zbor::err_no_memory);
+    codec.clear();
+
+    // Odd number of items in map
+    auto odd = codec.begin_map();
+    codec.encode(1);
+    ASSERT_EQ(odd.end(), zbor::err_out_of_bounds);
+}
+
+TEST_F(Encode, DeferredConstexpr)
+{
+    static constexpr auto ce_codec = []()
+    {
+        zbor::codec<32> codec;
+        auto arr = codec.begin_arr();
+        for (int i = 0; i < 25; ++i)
+            codec.encode_uint(0);
+        arr.end();
+        return codec;
+    }();
+    static_assert(ce_codec.size() == 27);
+    static_assert(ce_codec[0] == 0x98 && ce_codec[1] == 25);
+}
+
+TEST_F(Encode, Fragment)
+{
+    using namespace zbor::literals;
+    using namespace std::literals;
+
+    constexpr auto head = zbor::fragment<2_map, "ts"_txt>;
+    constexpr auto key = zbor::fragment<"val"_txt>;
+    constexpr auto mixed = zbor::fragment<1000, -1, 1.5, true, zbor::prim_null, 1_tag, 2_arr>;
+
+    static_assert(head.size() == 4);
+    static_assert(key.size() == 4);
+    static_assert(mixed.size() == 3 + 1 + 3 + 1 + 1 + 1 + 1);
+
+    codec.encode_(head, 1, key, 2.5f, mixed);
+
+    check(codec, {
+        0xa2, 0x62, 0x74, 0x73, 0x01,
+        0x63, 0x76, 0x61, 0x6c, 0xf9, 0x41, 0x00,
+        0x19, 0x03, 0xe8, 0x20, 0xf9, 0x3e, 0x00, 0xf5, 0xf6, 0xc1, 0x82,
+    });
+
+    const auto big = zbor::fragment<"0123456789012345678901234567890123456789012345678901234567890123456789012345"_txt>;
+    ASSERT_EQ(codec.encode(big), zbor::err_no_memory);
+}
+
+/**
+ * @brief Encode numbers with encode_array() and element by element, 
+ * outputs must be the same.
+ * 
+ */
+template<class T>
+static void check_array(const std::vector<T>& val)
+{
+    std::vector<uint8_t> a(val.size() * 9 + 9), b(a.size());
+    zbor::view batch{a}, single{b};
+
+    ASSERT_EQ(batch.encode_array(val), zbor::err_ok);
+    single.encode_arr(val.size());
+    for (auto v : val)
+        single.encode(v);
+
+    ASSERT_EQ(batch.size(), single.size());
+    for (size_t i = 0; i < batch.size(); ++i)
+        ASSERT_EQ(batch[i], single[i]) << "at index " << i;
+}
+
+TEST_F(Encode, Array)
+{
+    std::vector<int64_t> ints;
+    for (int64_t i = -70000; i < 70000; i += 7)
+        ints.push_back(i);
+    ints.insert(ints.end(), {INT64_MIN, INT64_MAX, -1ll << 32, 1ll << 32, -25, -24, 23, 24});
+    for (int i = 0; i < 100; ++i)
+        ints.push_back(i % 48 - 24);
+
+    check_array(ints);
+    check_array(std::vector<int>(ints.begin(), ints.end()));
+    check_array(std::vector<unsigned>(ints.begin(), ints.end()));
+    check_array(std::vector<uint64_t>(ints.begin(), ints.end()));
+    check_array(std::vector<int16_t>(ints.begin(), ints.end()));
+    check_array(std::vector<uint8_t>(ints.begin(), ints.end()));
+    check_array(std::vector<int8_t>(ints.begin(), ints.end()));
+
+    std::vector<float> floats = {
+        0.0f, -0.0f, 1.0f, -1.5f, 65504.0f, 65520.0f, 65536.0f, 1e-8f, 0.1f,
+        std::ldexp(1.0f, -24), std::ldexp(3.0f, -24), std::ldexp(1.0f, -25), std::ldexp(1.0f, -14), 
+        std::ldexp(1023.0f, -24), std::ldexp(1025.0f, -24), std::ldexp(1.0f, -140), 
+        INFINITY, -INFINITY, NAN, -NAN, 3.4e38f,
+    };
+    for (int i = 0; i < 20000; ++i)
+        floats.push_back(std::ldexp(float(i % 2048), i % 60 - 40));
+
+    check_array(floats);
+    check_array(std::vector<double>(floats.begin(), floats.end()));
+    check_array(std::vector<double>{0.1, 1e300, -1e-300, 1.5, NAN, INFINITY, 65504.0, 5e-324});
+
+    // Element by element if worst case doesn't fit
+    const uint64_t small[] = {1, 2, 3, 1000};
+    ASSERT_EQ(codec.encode_array(std::span{small}), zbor::err_ok);
+    codec.clear();
+    codec.resize(71);
+    ASSERT_EQ(codec.encode_array(std::span{small}), zbor::err_no_memory);
+    codec.clear();
+    codec.resize(70);
+    ASSERT_EQ(codec.encode_array(std::span{small}), zbor::err_ok);
+    ASSERT_EQ(codec.size(), 70 + 1 + 3 + 3);
+
+    // Empty
+    codec.clear();
+    ASSERT_EQ(codec.encode_array(std::vector<float>{}), zbor::err_ok);
+    check(codec, {0x80});
+
+    constexpr auto ce = [] {
+        const float in[] = {1.0f, 0.1f, 2, 3, 4, 5, 6, 7, 8};
+        zbor::codec<64> c;
+        c.encode_array(in);
+        return c;
+    }();
+    static_assert(ce.size() == 1 + 3 + 5 + 7 * 3);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "zbor/gather.h"
+#include <vector>
+
+using namespace zbor;
+
+namespace {
+
+/**
+ * @brief Concatenate all segments, as writev() would do.
+ *
+ */
+std::vector<byte> flatten(std::span<const iovec> vec)
+{
+    std::vector<byte> out;
+    for (auto& v : vec) {
+        auto p = static_cast<const byte*>(v.iov_base);
+        out.insert(out.end(), p, p + v.iov_len);
+    }
+    return out;
+}
+
+/**
+ * @brief Deferred length handle of codec has end() without count.
+ *
+ */
+template<class T>
+concept countable = requires (enc::builder<T>& b) { b.end(); };
+
+}
+
+TEST(Gather, Segments)
+{
+    using namespace std::literals;
+
+    std::vector<byte> blob(1000, 0xab);
+    const auto text = "some text which is long enough"sv;
+
+    byte buf[64];
+    iovec vec[8];
+    gather_view codec{buf, vec, 16};
+
+    ASSERT_EQ(codec.limit(), 16);
+    ASSERT_EQ(codec.encode_(1, "short"sv), err_ok);
+    ASSERT_EQ(codec.encode_data(blob), err_ok);
+    ASSERT_EQ(codec.encode(text), err_ok);
+    ASSERT_EQ(codec.encode_(2), err_ok);
+
+    auto iov = codec.iov();
+
+    ASSERT_EQ(iov.size(), 5);
+    ASSERT_EQ(iov[0].iov_base, buf);
+    ASSERT_EQ(iov[0].iov_len, 1 + 6 + 3);
+    ASSERT_EQ(iov[1].iov_base, blob.data());
+    ASSERT_EQ(iov[1].iov_len, blob.size());
+    ASSERT_EQ(iov[2].iov_len, 2);
+    ASSERT_EQ(iov[3].iov_base, text.data());
+    ASSERT_EQ(iov[4].iov_len, 1);
+    ASSERT_EQ(codec.size(), 1 + 6 + 3 + 2 + 1);
+    ASSERT_EQ(codec.total(), codec.size() + blob.size() + text.size());
+
+    // Same output as regular codec
+    std::vector<byte> ref(2048);
+    view plain{ref};
+    plain.encode_(1, "short"sv);
+    plain.encode_data(blob);
+    plain.encode(text);
+    plain.encode_(2);
+    ref.resize(plain.size());
+
+    ASSERT_EQ(flatten(iov), ref);
+
+    codec.clear();
+    ASSERT_EQ(codec.iov().size(), 0);
+    ASSERT_EQ(codec.total(), 0);
+}
+
+TEST(Gather, Fallback)
+{
+    std::vector<byte> blob(20, 0xcd);
+
+    byte buf[128];
+    iovec vec[4];
+    gather_view codec{buf, vec, 16};
+
+    // Only one reference fits, next strings are copied
+    ASSERT_EQ(codec.encode_data(blob), err_ok);
+    ASSERT_EQ(codec.encode_data(blob), err_ok);
+    ASSERT_EQ(codec.encode_data(blob), err_ok);
+
+    auto iov = codec.iov();
+    ASSERT_EQ(iov.size(), 3);
+    ASSERT_EQ(iov[2].iov_len, 2 * (1 + blob.size()));
+    ASSERT_EQ(flatten(iov).size(), 3 * (1 + blob.size()));
+
+    // Copied string doesn't fit
+    ASSERT_EQ(codec.encode_data(std::vector<byte>(200)), err_no_memory);
+}
+
+TEST(Gather, Deferred)
+{
+    std::vector<byte> blob(100, 0xef);
+
+    // Head widened after references were recorded
+    auto fill = [&](auto& codec) {
+        codec.encode(1);
+        auto arr = codec.begin_arr();
+        codec.encode_data(blob);
+        for (int i = 0; i < 30; ++i)
+            codec.encode(i);
+        codec.encode_data(blob);
+        codec.encode(2);
+        return arr.end(32);
+    };
+
+    byte buf[128];
+    iovec vec[8];
+    gather_view codec{buf, vec, 16};
+    ASSERT_EQ(fill(codec), err_ok);
+
+    std::vector<byte> ref(512);
+    view plain{ref};
+    ASSERT_EQ(fill(plain), err_ok);
+    ref.resize(plain.size());
+
+    ASSERT_EQ(codec.iov().size(), 5);
+    ASSERT_EQ(flatten(codec.iov()), ref);
+
+    // Items can't be counted in storage
+    static_assert(!countable<gather_view>);
+    static_assert(countable<view>);
+}
+
+TEST(Gather, NoEntries)
+{
+    byte buf[16];
+    gather_view codec{buf, {}, 4};
+
+    ASSERT_EQ(codec.encode_data(list{1, 2, 3, 4, 5}), err_ok);
+    ASSERT_EQ(codec.size(), 6);
+    ASSERT_EQ(codec.iov().size(), 0);
+}
@@ -0,0 +1,360 @@
+#include <gtest/gtest.h>
+#include "zbor/idx.h"
+
+using namespace zbor;
+
+TEST(Tape, Build)
+{
+    const byte test[] = {
+        0x01, // 1
+        0x83, 0x01, 0x82, 0x02, 0x03, 0x9f, 0x04, 0x05, 0xff, // [1, [2, 3], [_ 4, 5]]
+        0xa2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x82, 0x02, 0x03, // {"a": 1, "b": [2, 3]}
+        0xc1, 0x1a, 0x51, 0x4b, 0x67, 0xb0, // 1(1363896240)
+        0x5f, 0x42, 0x01, 0x02, 0x43, 0x03, 0x04, 0x05, 0xff, // (_ h'0102', h'030405')
+        0x80, // []
+        0x20, // -1
+    };
+
+    idx::node nodes[32];
+    zbor::tape tape{nodes};
+
+    auto [e, p] = tape.build(test);
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(p, test + sizeof(test));
+    ASSERT_EQ(tape.size(), 21);
+
+    ASSERT_EQ(tape[0].type, type_uint);
+    ASSERT_EQ(tape[0].val, 1);
+    ASSERT_EQ(tape.next(0), 1);
+
+    ASSERT_EQ(tape[1].type, type_array);
+    ASSERT_EQ(tape[1].head, 1);
+    ASSERT_EQ(tape[1].tail, 10);
+    ASSERT_EQ(tape[1].val, 3);
+    ASSERT_EQ(tape.next(1), 9);
+    ASSERT_EQ(tape.count(1), 3);
+    ASSERT_EQ(tape.child(1, 0), 2);
+    ASSERT_EQ(tape.child(1, 1), 3);
+    ASSERT_EQ(tape.child(1, 2), 6);
+    ASSERT_EQ(tape.child(1, 3), idx::npos);
+
+    ASSERT_EQ(tape[6].type, type_array);
+    ASSERT_EQ(tape[6].tail, 10);
+    ASSERT_EQ(tape[6].val, 2);
+    ASSERT_EQ(tape.count(6), 2);
+    ASSERT_EQ(tape.child(6, 1), 8);
+    ASSERT_EQ(tape[8].val, 5);
+
+    ASSERT_EQ(tape[9].type, type_map);
+    ASSERT_EQ(tape[9].tail, 19);
+    ASSERT_EQ(tape.count(9), 4);
+    ASSERT_EQ(tape.next(9), 16);
+    ASSERT_EQ(tape.get(tape.child(9, 2)).text, "b");
+    ASSERT_EQ(tape.get(tape.child(9, 3)).type, type_array);
+
+    ASSERT_EQ(tape[16].type, type_tag);
+    ASSERT_EQ(tape[16].val, 1);
+    ASSERT_EQ(tape[tape.child(16, 0)].val, 1363896240);
+
+    ASSERT_EQ(tape[18].type, type_indef_data);
+    ASSERT_EQ(tape[18].tail, 34);
+    ASSERT_EQ(tape.next(18), 19);
+
+    ASSERT_EQ(tape[19].type, type_array);
+    ASSERT_EQ(tape.next(19), 20);
+    ASSERT_EQ(tape.count(19), 0);
+    ASSERT_EQ(tape.child(19, 0), idx::npos);
+
+    ASSERT_EQ(tape[20].type, type_sint);
+}
+
+TEST(Tape, Get)
+{
+    const byte test[] = {
+        0x82, 0x9f, 0x01, 0x02, 0xff, 0x83, 0x01, 0x02, 0x03, // [[_ 1, 2], [1, 2, 3]]
+    };
+
+    idx::node nodes[8];
+    zbor::tape tape{nodes};
+
+    ASSERT_EQ(std::get<err>(tape.build(test)), err_ok);
+
+    auto root = tape.get(0);
+
+    ASSERT_EQ(root.type, type_array);
+    ASSERT_EQ(root.arr.size(), 2);
+    ASSERT_EQ(root.arr.data() + root.arr.seq::size(), test + sizeof(test));
+
+    auto nested = tape.get(tape.child(0, 1));
+
+    ASSERT_EQ(nested.type, type_array);
+    ASSERT_EQ(nested.arr.data(), test + 6);
+    ASSERT_EQ(nested.arr.seq::size(), 3);
+
+    uint64_t sum = 0;
+    for (auto it : nested.arr)
+        sum += it.uint;
+    ASSERT_EQ(sum, 6);
+
+    ASSERT_EQ(tape.count(1), 2);
+    ASSERT_EQ(tape.child(1, 1), 3);
+
+    // Indefinite map counts pairs like definite one
+    const byte map[] = { 0xbf, 0x01, 0x82, 0x02, 0x03, 0x04, 0x05, 0xff }; // {_ 1: [2, 3], 4: 5}
+
+    ASSERT_EQ(std::get<err>(tape.build(map)), err_ok);
+    ASSERT_EQ(tape[0].val, 2);
+    ASSERT_EQ(tape.count(0), 4);
+    ASSERT_EQ(tape.child(0, 3), 6);
+    ASSERT_EQ(tape.get(tape.child(0, 3)).uint, 5);
+}
+
+TEST(Tape, Constexpr)
+{
+    static constexpr byte test[] = {
+        0xa2, 0x01, 0x82, 0x02, 0x03, 0x04, 0x05, // {1: [2, 3], 4: 5}
+    };
+    static constexpr auto val = []()
+    {
+        idx::node nodes[8]{};
+        zbor::tape tape{nodes};
+        tape.build(test);
+        return tape.get(tape.child(0, 3)).uint;
+    }();
+    static_assert(val == 5);
+}
+
+TEST(Tape, Errors)
+{
+    idx::node nodes[4];
+    zbor::tape tape{nodes};
+
+    std::array<byte, 3> test_1 = { 0x82, 0x01, 0xff };
+    std::array<byte, 2> test_2 = { 0x82, 0x01 };
+    std::array<byte, 6> test_3 = { 0x9f, 0x01, 0x02, 0x03, 0x04, 0xff };
+    std::array<byte, 3> test_4 = { 0x9f, 0x01, 0x02 };
+    std::array<byte, 2> test_5 = { 0x9f, 0x1c };
+    std::array<byte, 3> test_6 = { 0x9b, 0xff, 0xff };
+    std::array<byte, 10> test_7 = { 0x9b, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00 };
+    std::array<byte, 10> test_8 = { 0xbb, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+    auto [e, p] = tape.build(test_1);
+
+    ASSERT_EQ(e, err_invalid_break);
+    ASSERT_EQ(p, test_1.begin() + 3);
+
+    std::tie(e, p) = tape.build(test_2);
+
+    ASSERT_EQ(e, err_out_of_bounds);
+    ASSERT_EQ(p, test_2.begin() + 1);
+
+    std::tie(e, p) = tape.build(test_3);
+
+    ASSERT_EQ(e, err_no_memory);
+    ASSERT_EQ(p, test_3.begin() + 4);
+    ASSERT_EQ(tape.size(), 4);
+
+    std::tie(e, p) = tape.build(test_4);
+
+    ASSERT_EQ(e, err_out_of_bounds);
+
+    std::tie(e, p) = tape.build(test_5);
+
+    ASSERT_EQ(e, err_reserved_ai);
+    ASSERT_EQ(p, test_5.begin() + 2);
+
+    std::tie(e, p) = tape.build(test_6);
+
+    ASSERT_EQ(e, err_out_of_bounds);
+
+    std::tie(e, p) = tape.build(test_7);
+
+    ASSERT_EQ(e, err_out_of_bounds);
+    ASSERT_EQ(p, test_7.begin() + 9);
+
+    std::tie(e, p) = tape.build(test_8);
+
+    ASSERT_EQ(e, err_out_of_bounds);
+    ASSERT_EQ(p, test_8.begin() + 9);
+
+    std::array<byte, 11> test_9 = { 0x5f, 0x5b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf7, 0xff };
+
+    std::tie(e, p) = tape.build(test_9);
+
+    ASSERT_EQ(e, err_out_of_bounds);
+
+    std::array<byte, 3> test_10 = { 0xbf, 0x01, 0xff };
+
+    std::tie(e, p) = tape.build(test_10);
+
+    ASSERT_EQ(e, err_invalid_break);
+    ASSERT_EQ(p, test_10.begin() + 3);
+}
+
+TEST(MapIndex, Find)
+{
+    const byte test[] = {
+        0xa6, // {
+            0x61, 0x61, 0x01, // "a": 1
+            0x61, 0x62, 0x82, 0x02, 0x03, // "b": [2, 3]
+            0x18, 0x2a, 0x63, 0x66, 0x6f, 0x6f, // 42: "foo"
+            0x20, 0xf5, // -1: true
+            0x81, 0x00, 0x00, // [0]: 0
+            0x61, 0x61, 0x02, // "a": 2
+        // }
+    };
+
+    auto [o, e, p] = decode(test, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+
+    idx::slot slots[4];
+    map_index small{slots};
+
+    ASSERT_EQ(small.build(o.map), err_no_memory);
+
+    idx::slot more_slots[16];
+    map_index index{more_slots};
+
+    ASSERT_EQ(index.build(o.map), err_ok);
+    ASSERT_EQ(index.size(), 5);
+    ASSERT_EQ(index.capacity(), 16);
+
+    ASSERT_EQ(index["a"].uint, 1);
+    ASSERT_EQ(index["b"].arr.size(), 2);
+    ASSERT_EQ(index[42].text, "foo");
+    ASSERT_EQ(index[-1].prim, prim_true);
+    ASSERT_EQ(index["c"].valid(), false);
+    ASSERT_EQ(index[0].valid(), false);
+    ASSERT_EQ(index[-42].valid(), false);
+}
+
+TEST(MapIndex, Errors)
+{
+    const byte test[] = { 0xa2, 0x01, 0x02, 0x03, 0x1c };
+
+    auto [o, e, p] = decode_lazy(test, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+
+    idx::slot slots[4];
+    map_index index{slots};
+
+    ASSERT_EQ(index.build(o.map), err_reserved_ai);
+}
+
+TEST(ArrIndex, Uniform)
+{
+    const byte test[] = {
+        0x85, 0xfa, 0x3f, 0x80, 0x00, 0x00, 0xfa, 0x40, 0x00, 0x00, 0x00, 0xfa, 0x40, 0x40, 0x00, 0x00, 
+              0xfa, 0x40, 0x80, 0x00, 0x00, 0xfa, 0x40, 0xa0, 0x00, 0x00, // [1.0, 2.0, 3.0, 4.0, 5.0] as float32
+        0x84, 0x18, 0x18, 0x38, 0x18, 0x18, 0xff, 0xf8, 0x20, // [24, -25, 255, simple(32)]
+        0x83, 0x41, 0x01, 0x41, 0x02, 0x41, 0x03, // [h'01', h'02', h'03']
+    };
+
+    auto [o, e, p] = decode(test, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+
+    arr_index index;
+
+    ASSERT_EQ(index.build(o.arr), err_ok);
+    ASSERT_EQ(index.size(), 5);
+    ASSERT_EQ(index.stride(), 5);
+    ASSERT_EQ(index[0].fp, 1.0);
+    ASSERT_EQ(index[3].fp, 4.0);
+    ASSERT_EQ(index[4].fp, 5.0);
+    ASSERT_EQ(index[5].valid(), false);
+
+    std::tie(o, e, p) = decode_lazy(p, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(index.build(o.arr), err_ok);
+    ASSERT_EQ(index.stride(), 2);
+    ASSERT_EQ(index[0].uint, 24);
+    ASSERT_EQ(index[1].sint, -25);
+    ASSERT_EQ(index[2].uint, 255);
+    ASSERT_EQ(index[3].prim, 32);
+
+    std::tie(o, e, p) = decode(p + 8, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(index.build(o.arr), err_ok);
+    ASSERT_EQ(index.stride(), 2);
+    ASSERT_EQ(index[2].data[0], 0x03);
+}
+
+TEST(ArrIndex, Table)
+{
+    const byte test[] = {
+        0x86, 0x18, 0x02, 0x19, 0x01, 0x02, 0x03, 0x82, 0x04, 0x05, 0x61, 0x61, 0x18, 0x06, // [2, 258, 3, [4, 5], "a", 6]
+        0x9f, 0x01, 0x18, 0x02, 0x81, 0x03, 0xff, // [_ 1, 2, [3]]
+    };
+
+    auto [o, e, p] = decode(test, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+
+    arr_index none;
+
+    ASSERT_EQ(none.build(o.arr), err_no_memory);
+
+    uint32_t full_table[6];
+    arr_index full{full_table};
+
+    ASSERT_EQ(full.build(o.arr), err_ok);
+    ASSERT_EQ(full.stride(), 0);
+    ASSERT_EQ(full[0].uint, 2);
+    ASSERT_EQ(full[1].uint, 258);
+    ASSERT_EQ(full[2].uint, 3);
+    ASSERT_EQ(full[3].arr.size(), 2);
+    ASSERT_EQ(full[4].text, "a");
+    ASSERT_EQ(full[5].uint, 6);
+    ASSERT_EQ(full[6].valid(), false);
+
+    uint32_t part_table[2];
+    arr_index part{part_table};
+
+    ASSERT_EQ(part.build(o.arr), err_ok);
+
+    for (size_t i = 0; i < full.size(); ++i)
+        ASSERT_EQ(part[i].type, full[i].type);
+    ASSERT_EQ(part[5].uint, 6);
+
+    std::tie(o, e, p) = decode(p, test + sizeof(test));
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(full.build(o.arr), err_ok);
+    ASSERT_EQ(full.size(), 3);
+    ASSERT_EQ(full[1].uint, 2);
+    ASSERT_EQ(full[2].arr.size(), 1);
+    ASSERT_EQ(full[3].valid(), false);
+
+    // Failed build leaves index empty
+    std::tie(o, e, p) = decode(test, test + sizeof(test));
+    ASSERT_EQ(none.build(o.arr), err_no_memory);
+    ASSERT_EQ(none.size(), 0);
+    ASSERT_EQ(none[0].valid(), false);
+}
+
+TEST(ArrIndex, Errors)
+{
+    // Lazy array which element is missing
+    const byte test_1[] = { 0x81 };
+    const byte test_2[] = { 0x82, 0x41 };
+
+    uint32_t table[2];
+    arr_index index{table};
+
+    auto [o, e, p] = decode_lazy(std::begin(test_1), std::end(test_1));
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(index.build(o.arr), err_out_of_bounds);
+    ASSERT_EQ(index.size(), 0);
+    ASSERT_EQ(index[0].valid(), false);
+
+    std::tie(o, e, p) = decode_lazy(std::begin(test_2), std::end(test_2));
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(index.build(o.arr), err_out_of_bounds);
+    ASSERT_EQ(index[1].valid(), false);
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "zbor/mapped.h"
+#include "zbor/enc.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace zbor;
+
+namespace {
+
+/**
+ * @brief Temporary file removed at the end of test.
+ *
+ */
+struct temp_file {
+    temp_file(span content)
+    {
+        int fd = mkstemp(path.data());
+        EXPECT_GE(fd, 0);
+        EXPECT_EQ(write(fd, content.data(), content.size()), ssize_t(content.size()));
+        ::close(fd);
+    }
+    ~temp_file() { unlink(path.c_str()); }
+    std::string path = "/tmp/zbor_mapped_XXXXXX";
+};
+
+}
+
+TEST(Mapped, Window)
+{
+    std::vector<byte> buf(1 << 16);
+    std::vector<byte> blob(20000, 0xab);
+    view c{buf};
+
+    // Items cross boundaries of 4 KB windows, blob is larger than window
+    for (int i = 0; i < 1000; ++i)
+        c.encode_(enc::arr(3), i, "record", 0.5 * i);
+    c.encode(span{blob});
+    for (int i = 0; i < 100; ++i)
+        c.encode(i);
+
+    temp_file file{{buf.data(), c.size()}};
+
+    for (size_t window : {size_t(1), size_t(4096), mapped_seq::default_window}) {
+        mapped_seq in{file.path.c_str(), window};
+        ASSERT_TRUE(in.is_open());
+        ASSERT_EQ(in.size(), c.size());
+
+        auto it = seq{buf.data(), c.size()}.begin();
+        size_t n = 0;
+        uint64_t expect = 0;
+        for (auto [obj, off] : in) {
+            ASSERT_TRUE(it != seq{}.end());
+            ASSERT_EQ(obj.type, (*it).type);
+            ASSERT_EQ(off, expect);
+            expect = uint64_t(it.pos() - buf.data());
+            if (obj.type == type_data) {
+                ASSERT_EQ(obj.data.size(), blob.size());
+            }
+            if (obj.type == type_array) {
+                ASSERT_EQ((*obj.arr.begin()).uint, n);
+            }
+            ++it;
+            ++n;
+        }
+        ASSERT_EQ(n, 1101);
+        ASSERT_FALSE(it != seq{}.end());
+        ASSERT_EQ(in.status(), err_ok);
+    }
+
+    // Whole file fits into default window
+    mapped_seq in{file.path.c_str()};
+    ASSERT_EQ(in.window().size(), c.size());
+    ASSERT_EQ(in.offset(), 0);
+
+    mapped_seq moved = std::move(in);
+    ASSERT_FALSE(in.is_open());
+    ASSERT_TRUE(moved.is_open());
+    ASSERT_EQ(moved.window().size(), c.size());
+}
+
+TEST(Mapped, Offsets)
+{
+    std::vector<byte> buf(256);
+    view c{buf};
+    std::vector<uint64_t> offsets;
+
+    for (int i = 0; i < 10; ++i) {
+        offsets.push_back(c.size());
+        c.encode_(enc::map(1), "n", i * 1000);
+    }
+    temp_file file{{buf.data(), c.size()}};
+    mapped_seq in{file.path.c_str(), 16};
+
+    size_t i = 0;
+    for (auto [obj, off] : in) {
+        ASSERT_EQ(off, offsets[i]);
+        ASSERT_EQ(obj.map["n"].uint, i * 1000);
+        ++i;
+    }
+    ASSERT_EQ(i, offsets.size());
+
+    // Traversal can be restarted
+    i = 0;
+    for ([[maybe_unused]] auto it : in)
+        ++i;
+    ASSERT_EQ(i, offsets.size());
+}
+
+TEST(Mapped, Errors)
+{
+    const byte test_1[] = {0x01, 0x02, 0x19, 0x01};
+    const byte test_2[] = {0x01, 0xff, 0x02};
+
+    temp_file file_1{test_1};
+    mapped_seq in_1{file_1.path.c_str()};
+    size_t n = 0;
+    for ([[maybe_unused]] auto it : in_1)
+        ++n;
+    ASSERT_EQ(n, 2);
+    ASSERT_EQ(in_1.status(), err_out_of_bounds);
+
+    temp_file file_2{test_2};
+    mapped_seq in_2{file_2.path.c_str()};
+    n = 0;
+    for ([[maybe_unused]] auto it : in_2)
+        ++n;
+    ASSERT_EQ(n, 1);
+    ASSERT_EQ(in_2.status(), err_invalid_break);
+
+    // Declared extent past end of file fails without remapping whole file
+    std::vector<byte> buf(1 << 14);
+    view c{buf};
+    c.encode_(1, enc::arr(2), "text", uint64_t(1) << 40);
+    buf[c.size()] = 0x7a;
+    buf[c.size() + 1] = 0x01;
+    temp_file file_5{buf};
+    mapped_seq in_5{file_5.path.c_str(), 1};
+    size_t page = in_5.window().size();
+    n = 0;
+    for ([[maybe_unused]] auto it : in_5)
+        ++n;
+    ASSERT_EQ(n, 2);
+    ASSERT_EQ(in_5.status(), err_out_of_bounds);
+    ASSERT_EQ(in_5.offset(), 0);
+    ASSERT_EQ(in_5.window().size(), page);
+
+    temp_file empty{span{}};
+    mapped_seq in_3{empty.path.c_str()};
+    ASSERT_TRUE(in_3.is_open());
+    ASSERT_EQ(in_3.size(), 0);
+    ASSERT_FALSE(in_3.begin() != in_3.end());
+
+    mapped_seq in_4{"/nonexistent/zbor.cborseq"};
+    ASSERT_FALSE(in_4.is_open());
+    ASSERT_FALSE(in_4.begin() != in_4.end());
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include "zbor/parallel.h"
+#include "zbor/enc.h"
+#include <atomic>
+#include <vector>
+
+using namespace zbor;
+
+namespace {
+
+/**
+ * @brief Generate sequence of records with mixed items and nested containers.
+ *
+ */
+std::vector<byte> records(size_t n)
+{
+    using namespace std::literals;
+
+    std::vector<byte> buf(n * 32);
+    view c{buf};
+
+    for (size_t i = 0; i < n; ++i) {
+        switch (i % 4)
+        {
+        case 0: c.encode(i); break;
+        case 1: c.encode_(enc::arr(2), i, "value"sv); break;
+        case 2: c.encode_(enc::indef_map(), "id"sv, i, enc::breaker()); break;
+        case 3: c.encode_(enc::tag(1), i); break;
+        }
+    }
+    buf.resize(c.size());
+    return buf;
+}
+
+/**
+ * @brief Number stored in record, see records().
+ *
+ */
+uint64_t number(const item& obj)
+{
+    switch (obj.type)
+    {
+    case type_uint: return obj.uint;
+    case type_array: return obj.arr[0].uint;
+    case type_map: return obj.map["id"].uint;
+    case type_tag: return obj.tag.content().uint;
+    default: return uint64_t(-1);
+    }
+}
+
+}
+
+TEST(Parallel, Unordered)
+{
+    const auto buf = records(5000);
+    const seq in{buf.data(), buf.size()};
+
+    for (size_t threads : {1, 2, 4, 8}) {
+        for (size_t chunk : {size_t(0), size_t(64), size_t(1) << 20}) {
+            std::vector<uint64_t> out(5000, uint64_t(-1));
+            std::atomic<size_t> calls = 0;
+
+            auto [e, off] = parallel_for_each(in, [&](const item& obj, size_t i) {
+                out[i] = number(obj);
+                ++calls;
+            }, {threads, chunk});
+
+            ASSERT_EQ(e, err_ok);
+            ASSERT_EQ(off, buf.size());
+            ASSERT_EQ(calls, 5000);
+            for (size_t i = 0; i < out.size(); ++i)
+                ASSERT_EQ(out[i], i);
+        }
+    }
+}
+
+TEST(Parallel, Ordered)
+{
+    const auto buf = records(5000);
+    const seq in{buf.data(), buf.size()};
+    std::vector<uint64_t> out;
+
+    auto [e, off] = parallel_for_each(in, [&](const item& obj, size_t i) {
+        ASSERT_EQ(i, out.size());
+        out.push_back(number(obj));
+    }, {4, 100, par_ordered});
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(off, buf.size());
+    ASSERT_EQ(out.size(), 5000);
+    for (size_t i = 0; i < out.size(); ++i)
+        ASSERT_EQ(out[i], i);
+}
+
+TEST(Parallel, Malformed)
+{
+    auto buf = records(1000);
+    const size_t at = buf.size();
+    const auto tail = records(1000);
+    size_t calls = 0;
+
+    // Break between items, preceding ones are visited also if they share range with it
+    buf.push_back(0xff);
+    buf.insert(buf.end(), tail.begin(), tail.end());
+
+    for (size_t chunk : {size_t(1), size_t(100), size_t(1) << 20}) {
+        calls = 0;
+        auto [e, off] = parallel_for_each(seq{buf.data(), buf.size()}, [&](const item&, size_t i) {
+            ASSERT_EQ(i, calls++);
+        }, {3, chunk, par_ordered});
+        ASSERT_EQ(e, err_invalid_break);
+        ASSERT_EQ(off, at);
+        ASSERT_EQ(calls, 1000);
+    }
+
+    // Empty and truncated input
+    calls = 0;
+    ASSERT_EQ(parallel_for_each(seq{}, [&](const item&, size_t) { ++calls; }), std::make_tuple(err_ok, size_t(0)));
+    ASSERT_EQ(calls, 0);
+
+    const byte test[] = {0x01, 0x02, 0x19, 0x01};
+    calls = 0;
+    ASSERT_EQ(parallel_for_each(seq{test}, [&](const item&, size_t) { ++calls; }, {2, 1, par_ordered}), std::make_tuple(err_out_of_bounds, size_t(2)));
+    ASSERT_EQ(calls, 2);
+}
+
+TEST(Parallel, DecodeError)
+{
+    // Indefinite string with text chunk passes boundary scan, but not decoding
+    auto buf = records(1000);
+    const size_t at = buf.size();
+    const auto tail = records(1000);
+
+    buf.insert(buf.end(), {0x5f, 0x61, 0x61, 0xff});
+    buf.insert(buf.end(), tail.begin(), tail.end());
+
+    for (size_t chunk : {size_t(1), size_t(100), size_t(1) << 20}) {
+        size_t calls = 0;
+        auto [e, off] = parallel_for_each(seq{buf.data(), buf.size()}, [&](const item&, size_t i) {
+            ASSERT_EQ(i, calls++);
+        }, {3, chunk, par_ordered});
+        ASSERT_EQ(e, err_invalid_indef_string);
+        ASSERT_EQ(off, at);
+        ASSERT_EQ(calls, 1000);
+
+        std::atomic<size_t> before = 0;
+        std::tie(e, off) = parallel_for_each(seq{buf.data(), buf.size()}, [&](const item&, size_t i) {
+            before += i < 1000;
+        }, {3, chunk, par_unordered});
+        ASSERT_EQ(e, err_invalid_indef_string);
+        ASSERT_EQ(off, at);
+        ASSERT_EQ(before, 1000);
+    }
+}
+
+TEST(Parallel, Exception)
+{
+    const auto buf = records(5000);
+    const seq in{buf.data(), buf.size()};
+
+    for (auto order : {par_unordered, par_ordered}) {
+        std::atomic<size_t> calls = 0;
+        auto fn = [&](const item&, size_t i) {
+            ++calls;
+            if (i == 100)
+                throw std::runtime_error("stop");
+        };
+        ASSERT_THROW(parallel_for_each(in, fn, {4, 64, order}), std::runtime_error);
+        ASSERT_LT(calls, 5000);
+    }
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include "zbor/reflect.h"
+#include <vector>
+
+using namespace zbor;
+
+namespace {
+
+struct point {
+    int x;
+    int y;
+};
+ZBOR_FIELDS(point, x, y)
+
+struct record {
+    uint64_t ts;
+    float val;
+    std::array<int16_t, 3> seq;
+    std::string name;
+    bool ok;
+    std::vector<point> path;
+    std::vector<byte> blob;
+};
+ZBOR_FIELDS(record, ts, val, seq, name, ok, path, blob)
+
+// Fields listed in other order than declared, and not all of them
+struct partial {
+    int a;
+    int b;
+    int c;
+};
+ZBOR_FIELDS(partial, c, a)
+
+// Same field listed twice, so there is no perfect hash
+struct twice {
+    int a;
+};
+ZBOR_FIELDS(twice, a, a)
+
+}
+
+TEST(Reflect, Meta)
+{
+    using m = refl::meta<record>;
+
+    static_assert(m::size == 7);
+    static_assert(m::names[0] == "ts");
+    static_assert(m::names[6] == "blob");
+    static_assert(m::key<1>.size() == 4);
+    static_assert(m::key<1>[0] == 0x63);
+
+    byte name[] = {'n', 'a', 'm', 'e'};
+    ASSERT_EQ(m::find(dec::txt{name, 4}), 3);
+    ASSERT_EQ(m::find(dec::txt{name, 3}), m::size);
+
+    static_assert(m::index.ok);
+    static_assert(!refl::meta<twice>::index.ok);
+    ASSERT_EQ(refl::meta<twice>::find(dec::txt{name, 1}), 2);
+    ASSERT_EQ(refl::meta<twice>::find(dec::txt{reinterpret_cast<const byte*>("a"), 1}), 0);
+    static_assert(refl::meta<partial>::size == 2);
+    static_assert(refl::meta<partial>::names[0] == "c");
+    static_assert(!refl::reflected<int>);
+}
+
+TEST(Reflect, RoundTrip)
+{
+    record in{1600000000000, 0.5f, {-1, 300, 7}, "sensor", true, {{1, 2}, {-3, 4}}, {0xde, 0xad}};
+
+    codec<256> c;
+    ASSERT_EQ(encode(c, in), err_ok);
+
+    // Same output as handwritten encoding
+    using namespace std::literals;
+    codec<256> ref;
+    ref.encode_(
+        enc::map(7),
+        "ts"sv, uint64_t(1600000000000),
+        "val"sv, 0.5f,
+        "seq"sv, enc::arr(3), -1, 300, 7,
+        "name"sv, "sensor"sv,
+        "ok"sv, true,
+        "path"sv, enc::arr(2), enc::map(2), "x"sv, 1, "y"sv, 2, enc::map(2), "x"sv, -3, "y"sv, 4,
+        "blob"sv, list{0xde, 0xad});
+
+    ASSERT_EQ(c.size(), ref.size());
+    ASSERT_TRUE(std::equal(c.data(), c.data() + c.size(), ref.data()));
+
+    record out{};
+    ASSERT_EQ(decode_into(*c.begin(), out), err_ok);
+    ASSERT_EQ(out.ts, in.ts);
+    ASSERT_EQ(out.val, in.val);
+    ASSERT_EQ(out.seq, in.seq);
+    ASSERT_EQ(out.name, in.name);
+    ASSERT_EQ(out.ok, in.ok);
+    ASSERT_EQ(out.path.size(), 2);
+    ASSERT_EQ(out.path[1].x, -3);
+    ASSERT_EQ(out.path[1].y, 4);
+    ASSERT_EQ(out.blob, in.blob);
+
+    // Not enough memory
+    codec<16> small;
+    ASSERT_EQ(encode(small, in), err_no_memory);
+}
+
+TEST(Reflect, Decode)
+{
+    using namespace std::literals;
+    codec<64> c;
+
+    // Unknown and non-text keys are skipped, missing fields unchanged
+    c.encode_(enc::map(4), "z"sv, 1, "y"sv, 5, 1, 2, "xx"sv, 3);
+    point p{7, 7};
+    ASSERT_EQ(decode_into(*c.begin(), p), err_ok);
+    ASSERT_EQ(p.x, 7);
+    ASSERT_EQ(p.y, 5);
+
+    // Type mismatch
+    c.clear();
+    c.encode_(enc::map(1), "x"sv, "text"sv);
+    ASSERT_EQ(decode_into(*c.begin(), p), err_invalid_type);
+    c.clear();
+    c.encode_(enc::map(1), "x"sv, uint64_t(1) << 40);
+    ASSERT_EQ(decode_into(*c.begin(), p), err_invalid_type);
+    c.clear();
+    c.encode_(enc::arr(1), 1);
+    ASSERT_EQ(decode_into(*c.begin(), p), err_invalid_type);
+
+    // Fixed size array must match
+    c.clear();
+    c.encode_(enc::arr(2), 1, 2);
+    std::array<int, 3> a{};
+    ASSERT_EQ(decode_into(*c.begin(), a), err_invalid_type);
+    c.clear();
+    c.encode_(indef_arr, 1, 2, 3, breaker);
+    ASSERT_EQ(decode_into(*c.begin(), a), err_ok);
+    ASSERT_EQ(a[2], 3);
+}
+
+TEST(Reflect, Named)
+{
+    using namespace std::literals;
+
+    // Keys follow listed order and are bound by name
+    codec<32> c;
+    ASSERT_EQ(encode(c, partial{1, 2, 3}), err_ok);
+    codec<32> ref;
+    ref.encode_(enc::map(2), "c"sv, 3, "a"sv, 1);
+    ASSERT_EQ(c.size(), ref.size());
+    ASSERT_TRUE(std::equal(c.data(), c.data() + c.size(), ref.data()));
+
+    partial p{};
+    ASSERT_EQ(decode_into(*c.begin(), p), err_ok);
+    ASSERT_EQ(p.a, 1);
+    ASSERT_EQ(p.b, 0);
+    ASSERT_EQ(p.c, 3);
+}
+
+TEST(Reflect, Malformed)
+{
+    using namespace std::literals;
+    codec<64> c;
+    point p{};
+
+    // Lazy map with truncated value
+    c.encode_(enc::map(2), "x"sv, 1, "y"sv);
+    auto [obj, e, _] = decode_lazy(c.data(), c.data() + c.size());
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(decode_into(obj, p), err_out_of_bounds);
+    ASSERT_EQ(p.x, 1);
+
+    // Lazy indefinite map without break
+    c.clear();
+    c.encode_(indef_map, "x"sv, 2, "y"sv, 3);
+    std::tie(obj, e, _) = decode_lazy(c.data(), c.data() + c.size());
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(decode_into(obj, p), err_out_of_bounds);
+
+    // Break instead of value
+    c.clear();
+    c.encode_(indef_map, "x"sv, breaker);
+    std::tie(obj, e, _) = decode_lazy(c.data(), c.data() + c.size());
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(decode_into(obj, p), err_invalid_break);
+
+    // Lazy array with truncated element
+    c.clear();
+    c.encode_(enc::arr(3), 1, 2);
+    std::tie(obj, e, _) = decode_lazy(c.data(), c.data() + c.size());
+    std::vector<int> v;
+    ASSERT_EQ(decode_into(obj, v), err_out_of_bounds);
+    std::array<int, 3> a;
+    ASSERT_EQ(decode_into(obj, a), err_out_of_bounds);
+}
+
+TEST(Reflect, Constexpr)
+{
+    constexpr auto y = [] {
+        codec<32> c;
+        encode(c, point{1, -2});
+        point p{};
+        decode_into(*c.begin(), p);
+        return p.y;
+    }();
+    static_assert(y == -2);
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include "zbor/sax.h"
+#include <string>
+
+using namespace zbor;
+
+namespace {
+
+/**
+ * @brief Visitor which prints events in diagnostic-like notation.
+ *
+ */
+struct printer {
+    std::string out;
+    void on_uint(uint64_t val)      { out += std::to_string(val) + " "; }
+    void on_sint(int64_t val)       { out += std::to_string(val) + " "; }
+    void on_float(double val)       { out += std::to_string(val) + " "; }
+    void on_prim(prim val)          { out += 'p'; out += std::to_string(val) + " "; }
+    void on_data(span val)          { out += 'h'; out += std::to_string(val.size()) + " "; }
+    void on_text(dec::txt val)      { out += '"'; out.append(val.begin(), val.end()); out += "\" "; }
+    void on_tag(uint64_t val)       { out += std::to_string(val) + "("; }
+    void on_array_begin(size_t len) { out += len == size_t(-1) ? "[_ " : "["; }
+    void on_array_end()             { out += "] "; }
+    void on_map_begin(size_t len)   { out += len == size_t(-1) ? "{_ " : "{"; }
+    void on_map_end()               { out += "} "; }
+    void on_data_begin()            { out += "(_ "; }
+    void on_data_end()              { out += ") "; }
+};
+
+/**
+ * @brief Visitor which counts unsigned integers outside of maps.
+ *
+ */
+struct filter {
+    uint64_t sum = 0;
+    size_t maps = 0;
+    constexpr void on_uint(uint64_t val)    { sum += val; }
+    constexpr bool on_map_begin(size_t)     { ++maps; return false; }
+};
+
+const byte test[] = {
+    0x01, // 1
+    0x83, 0x01, 0x82, 0x02, 0x03, 0x9f, 0x04, 0x05, 0xff, // [1, [2, 3], [_ 4, 5]]
+    0xa2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x82, 0x02, 0x03, // {"a": 1, "b": [2, 3]}
+    0xc1, 0x1a, 0x51, 0x4b, 0x67, 0xb0, // 1(1363896240)
+    0x5f, 0x42, 0x01, 0x02, 0x43, 0x03, 0x04, 0x05, 0xff, // (_ h'0102', h'030405')
+    0x80, // []
+    0x20, // -1
+    0xf9, 0x3c, 0x00, // 1.0
+    0xf6, // null
+};
+
+}
+
+TEST(Sax, Events)
+{
+    printer v;
+
+    auto [e, p] = parse(test, v);
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(p, test + sizeof(test));
+    ASSERT_EQ(v.out,
+        "1 "
+        "[1 [2 3 ] [_ 4 5 ] ] "
+        "{\"a\" 1 \"b\" [2 3 ] } "
+        "1(1363896240 "
+        "(_ h2 h3 ) "
+        "[] "
+        "-1 "
+        "1.000000 "
+        "p22 ");
+}
+
+TEST(Sax, Filter)
+{
+    filter v;
+
+    auto [e, p] = parse(test, v);
+
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(p, test + sizeof(test));
+    ASSERT_EQ(v.maps, 1);
+    ASSERT_EQ(v.sum, 1 + 1 + 2 + 3 + 4 + 5 + 1363896240);
+
+    // Visitor without any handler only validates
+    struct {} none;
+    ASSERT_EQ(std::get<err>(parse(test, none)), err_ok);
+}
+
+TEST(Sax, Constexpr)
+{
+    constexpr auto sum = [] {
+        const byte in[] = { 0x82, 0x01, 0xa1, 0x02, 0x03, 0x9f, 0x04, 0xff };
+        filter v;
+        parse(in, v);
+        return v.sum;
+    }();
+    static_assert(sum == 5);
+}
+
+TEST(Sax, Errors)
+{
+    struct {} v;
+    {
+        const byte in[] = { 0x82, 0x01 };
+        auto [e, p] = parse(in, v);
+        ASSERT_EQ(e, err_out_of_bounds);
+        ASSERT_EQ(p, in + sizeof(in));
+    }
+    {
+        const byte in[] = { 0x82, 0x01, 0xff };
+        auto [e, p] = parse(in, v);
+        ASSERT_EQ(e, err_invalid_break);
+        ASSERT_EQ(p, in + 3);
+    }
+    {
+        const byte in[] = { 0x5f, 0x61, 0x61, 0xff };
+        auto [e, p] = parse(in, v);
+        ASSERT_EQ(e, err_invalid_indef_string);
+    }
+    {
+        const byte in[] = { 0x9b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01 };
+        auto [e, p] = parse(in, v);
+        ASSERT_EQ(e, err_invalid_length);
+        ASSERT_EQ(p, in + 9);
+    }
+    {
+        const byte in[] = { 0x81, 0x81, 0x81, 0x00 };
+        auto [e, p] = parse<2>(in, v);
+        ASSERT_EQ(e, err_no_memory);
+    }
+    {
+        const byte in[] = { 0x1c };
+        auto [e, p] = parse(in, v);
+        ASSERT_EQ(e, err_reserved_ai);
+    }
+    {
+        const byte in[] = { 0xdf };
+        auto [e, p] = parse(in, v);
+        ASSERT_EQ(e, err_invalid_indef_mt);
+    }
+    {
+        // Error inside skipped content
+        filter f;
+        const byte in[] = { 0xa1, 0x01, 0x1c };
+        auto [e, p] = parse(in, f);
+        ASSERT_EQ(e, err_reserved_ai);
+    }
+}
@@ -0,0 +1,304 @@
+#include <gtest/gtest.h>
+#include "zbor/stream.h"
+#include <vector>
+
+using namespace zbor;
+
+namespace {
+
+const byte test[] = {
+    0x01, // 1
+    0x83, 0x01, 0x82, 0x02, 0x03, 0x9f, 0x04, 0x05, 0xff, // [1, [2, 3], [_ 4, 5]]
+    0xa2, 0x61, 0x61, 0x01, 0x61, 0x62, 0x82, 0x02, 0x03, // {"a": 1, "b": [2, 3]}
+    0xc1, 0x1a, 0x51, 0x4b, 0x67, 0xb0, // 1(1363896240)
+    0x5f, 0x42, 0x01, 0x02, 0x43, 0x03, 0x04, 0x05, 0xff, // (_ h'0102', h'030405')
+    0x80, // []
+    0x20, // -1
+};
+
+// Type and depth of every emitted item
+const std::pair<type_t, size_t> expected[] = {
+    {type_uint, 0},
+    {type_array, 0}, {type_uint, 1}, {type_array, 1}, {type_uint, 2}, {type_uint, 2},
+    {type_array, 1}, {type_uint, 2}, {type_uint, 2},
+    {type_map, 0}, {type_text, 1}, {type_uint, 1}, {type_text, 1}, {type_array, 1},
+    {type_uint, 2}, {type_uint, 2},
+    {type_tag, 0}, {type_uint, 1},
+    {type_indef_data, 0}, {type_data, 1}, {type_data, 1},
+    {type_array, 0},
+    {type_sint, 0},
+};
+
+template<size_t Depth>
+std::vector<std::pair<type_t, size_t>> feed_all(stream_decoder<Depth>& dec, span in, size_t chunk)
+{
+    std::vector<std::pair<type_t, size_t>> out;
+
+    while (true) {
+        auto [obj, e] = dec.next();
+
+        if (e == err_out_of_bounds) {
+            if (in.empty())
+                break;
+            auto n = dec.feed(in.first(std::min(chunk, in.size())));
+            in = in.subspan(n);
+            continue;
+        }
+        EXPECT_EQ(e, err_ok);
+        if (e != err_ok)
+            break;
+        out.push_back({obj.type, dec.depth()});
+    }
+    return out;
+}
+
+}
+
+TEST(Stream, Chunks)
+{
+    for (size_t chunk = 1; chunk <= sizeof(test); ++chunk) {
+
+        byte window[8];
+        stream_decoder dec{window};
+
+        auto out = feed_all(dec, test, chunk);
+
+        ASSERT_EQ(out.size(), std::size(expected)) << chunk;
+        for (size_t i = 0; i < out.size(); ++i)
+            ASSERT_EQ(out[i], expected[i]) << chunk << " " << i;
+        ASSERT_TRUE(dec.idle());
+    }
+}
+
+TEST(Stream, Items)
+{
+    const byte in[] = { 0x82, 0x63, 0x61, 0x62, 0x63, 0xc1, 0x19, 0x01, 0x2c };
+
+    byte window[4];
+    stream_decoder dec{window};
+
+    auto [o1, e1] = dec.next();
+    ASSERT_EQ(e1, err_out_of_bounds);
+
+    ASSERT_EQ(dec.feed(in), 4);
+
+    auto [o2, e2] = dec.next();
+    ASSERT_EQ(e2, err_ok);
+    ASSERT_EQ(o2.type, type_array);
+    ASSERT_EQ(o2.arr.size(), 2);
+    ASSERT_FALSE(o2.arr.begin() != o2.arr.end());
+    ASSERT_EQ(dec.open(), 1);
+
+    // Text is incomplete
+    auto [o3, e3] = dec.next();
+    ASSERT_EQ(e3, err_out_of_bounds);
+    ASSERT_EQ(dec.buffered(), 3);
+
+    ASSERT_EQ(dec.feed(span{in}.subspan(4)), 1);
+
+    auto [o4, e4] = dec.next();
+    ASSERT_EQ(e4, err_ok);
+    ASSERT_EQ(o4.type, type_text);
+    ASSERT_EQ(o4.text, "abc");
+    ASSERT_EQ(dec.depth(), 1);
+
+    ASSERT_EQ(dec.feed(span{in}.subspan(5)), 4);
+
+    auto [o5, e5] = dec.next();
+    ASSERT_EQ(e5, err_ok);
+    ASSERT_EQ(o5.type, type_tag);
+    ASSERT_EQ(o5.tag.num(), 1);
+
+    auto [o6, e6] = dec.next();
+    ASSERT_EQ(e6, err_ok);
+    ASSERT_EQ(o6.uint, 300);
+    ASSERT_EQ(dec.depth(), 2);
+    ASSERT_TRUE(dec.idle());
+}
+
+TEST(Stream, Constexpr)
+{
+    constexpr auto count = [] {
+        const byte in[] = { 0x9f, 0x01, 0x82, 0x02, 0x03, 0xff, 0xf5 };
+        byte window[2]{};
+        stream_decoder dec{window};
+        size_t n = 0, i = 0;
+        while (true) {
+            auto [obj, e] = dec.next();
+            if (e == err_out_of_bounds && i < sizeof(in)) {
+                i += dec.feed({in + i, 1});
+                continue;
+            }
+            if (e != err_ok)
+                break;
+            ++n;
+        }
+        return n;
+    }();
+    static_assert(count == 6);
+}
+
+TEST(Stream, Errors)
+{
+    {
+        // String longer than window
+        const byte in[] = { 0x45, 0x01, 0x02, 0x03, 0x04, 0x05 };
+        byte window[4];
+        stream_decoder dec{window};
+        dec.feed(in);
+        auto [o, e] = dec.next();
+        ASSERT_EQ(e, err_no_memory);
+    }
+    {
+        // Nesting deeper than Depth
+        const byte in[] = { 0x81, 0x81, 0x81, 0x00 };
+        byte window[4];
+        stream_decoder<2> dec{window};
+        dec.feed(in);
+        ASSERT_EQ(std::get<err>(dec.next()), err_ok);
+        ASSERT_EQ(std::get<err>(dec.next()), err_ok);
+        ASSERT_EQ(std::get<err>(dec.next()), err_no_memory);
+    }
+    {
+        // Break inside definite array
+        const byte in[] = { 0x82, 0x01, 0xff };
+        byte window[4];
+        stream_decoder dec{window};
+        dec.feed(in);
+        ASSERT_EQ(std::get<err>(dec.next()), err_ok);
+        ASSERT_EQ(std::get<err>(dec.next()), err_ok);
+        ASSERT_EQ(std::get<err>(dec.next()), err_invalid_break);
+    }
+    {
+        // Text chunk within indefinite byte string
+        const byte in[] = { 0x5f, 0x61, 0x61, 0xff };
+        byte window[4];
+        stream_decoder dec{window};
+        dec.feed(in);
+        ASSERT_EQ(std::get<err>(dec.next()), err_ok);
+        ASSERT_EQ(std::get<err>(dec.next()), err_invalid_indef_string);
+    }
+    {
+        // Definite map with count of indefinite length
+        const byte in[] = { 0xbb, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+        byte window[16];
+        stream_decoder dec{window};
+        dec.feed(in);
+        ASSERT_EQ(std::get<err>(dec.next()), err_invalid_length);
+    }
+    {
+        // Reserved additional info
+        const byte in[] = { 0x1c };
+        byte window[4];
+        stream_decoder dec{window};
+        dec.feed(in);
+        ASSERT_EQ(std::get<err>(dec.next()), err_reserved_ai);
+        dec.reset();
+        ASSERT_TRUE(dec.idle());
+    }
+}
+
+TEST(StreamEncoder, Flush)
+{
+    using namespace std::literals;
+
+    std::vector<byte> out;
+    size_t calls = 0;
+
+    byte window[16];
+    stream_encoder enc{window, [&](span s) {
+        out.insert(out.end(), s.begin(), s.end());
+        ++calls;
+        return err_ok;
+    }};
+
+    std::vector<byte> blob(100, 0xab);
+
+    ASSERT_EQ(enc.encode_arr(1002), err_ok);
+    for (uint64_t i = 0; i < 1000; ++i)
+        ASSERT_EQ(enc.encode(i), err_ok);
+    ASSERT_EQ(enc.encode("text"sv), err_ok);
+    ASSERT_EQ(enc.encode_data(blob), err_ok);
+    ASSERT_LE(enc.size(), sizeof(window));
+    ASSERT_EQ(enc.flush(), err_ok);
+    ASSERT_EQ(enc.size(), 0);
+    ASSERT_EQ(enc.flushed(), out.size());
+
+    // Same output as regular codec
+    std::vector<byte> ref(4096);
+    view plain{ref};
+    plain.encode_arr(1002);
+    for (uint64_t i = 0; i < 1000; ++i)
+        plain.encode(i);
+    plain.encode("text"sv);
+    plain.encode_data(blob);
+    ref.resize(plain.size());
+
+    ASSERT_EQ(out, ref);
+    ASSERT_GT(calls, ref.size() / sizeof(window));
+}
+
+TEST(StreamEncoder, Errors)
+{
+    bool fail = false;
+
+    byte window[16];
+    stream_encoder enc{window, [&](span) {
+        return fail ? err_out_of_bounds : err_ok;
+    }};
+
+    for (int i = 0; i < 16; ++i)
+        ASSERT_EQ(enc.encode(0), err_ok);
+
+    fail = true;
+    ASSERT_EQ(enc.encode(0), err_no_memory);
+    ASSERT_EQ(enc.status(), err_out_of_bounds);
+    ASSERT_EQ(enc.flush(), err_out_of_bounds);
+    ASSERT_EQ(enc.size(), 16);
+
+    fail = false;
+    ASSERT_EQ(enc.encode(0), err_ok);
+    ASSERT_EQ(enc.flushed(), 16);
+}
+
+TEST(StreamEncoder, Deferred)
+{
+    std::vector<byte> out;
+
+    byte window[16];
+    stream_encoder enc{window, [&](span s) {
+        out.insert(out.end(), s.begin(), s.end());
+        return err_ok;
+    }};
+
+    // Container fits into window
+    auto arr = enc.begin_arr();
+    for (int i = 0; i < 3; ++i)
+        ASSERT_EQ(enc.encode(i), err_ok);
+    ASSERT_EQ(arr.end(), err_ok);
+    ASSERT_EQ(enc.flush(), err_ok);
+    ASSERT_EQ(out, (std::vector<byte>{0x83, 0x00, 0x01, 0x02}));
+
+    // Head was flushed before end()
+    size_t before = enc.flushed();
+    auto map = enc.begin_map();
+    for (int i = 0; i < 20; ++i)
+        ASSERT_EQ(enc.encode(i), err_ok);
+    ASSERT_GT(enc.flushed(), before);
+    ASSERT_EQ(map.end(), err_no_memory);
+    ASSERT_EQ(map.end(10), err_no_memory);
+
+    // Head must be widened, but window is full
+    byte full[26];
+    out.clear();
+    stream_encoder wide{full, [&](span s) {
+        out.insert(out.end(), s.begin(), s.end());
+        return err_ok;
+    }};
+    auto arr_25 = wide.begin_arr();
+    for (int i = 0; i < 25; ++i)
+        ASSERT_EQ(wide.encode(i % 24), err_ok);
+    ASSERT_EQ(arr_25.end(), err_no_memory);
+    ASSERT_EQ(wide.flushed(), 0);
+    ASSERT_TRUE(out.empty());
+}
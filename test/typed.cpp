@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "zbor/gather.h"
+#include "zbor/typed.h"
+#include <vector>
+
+using namespace zbor;
+
+TEST(Typed, Tags)
+{
+    static_assert(typed::tag<uint8_t>() == 64);
+    static_assert(typed::tag<uint16_t>(std::endian::big) == 65);
+    static_assert(typed::tag<uint64_t>(std::endian::little) == 71);
+    static_assert(typed::tag<int8_t>(std::endian::little) == 72);
+    static_assert(typed::tag<int16_t>(std::endian::little) == 77);
+    static_assert(typed::tag<float>(std::endian::big) == 81);
+    static_assert(typed::tag<float>(std::endian::little) == 85);
+    static_assert(typed::tag<double>(std::endian::little) == 86);
+
+    static_assert(!typed::parse(63).valid());
+    static_assert(!typed::parse(76).valid());
+    static_assert(!typed::parse(88).valid());
+    static_assert(typed::parse(68).size == 1);
+    static_assert(typed::parse(84).size == 2 && typed::parse(84).floating);
+    static_assert(typed::parse(87).size == 16);
+    static_assert(typed::parse(79).sign && typed::parse(79).order == std::endian::little);
+
+    for (uint64_t t = 64; t < 88; ++t) {
+        if (t == 68 || t == 76 || t == 83 || t == 87 || t == 80 || t == 84)
+            continue;
+        auto f = typed::parse(t);
+        bool ok = false;
+        // Every other tag is produced by some element type
+        for (auto order : {std::endian::big, std::endian::little}) {
+            ok |= typed::tag<uint8_t>(order) == t || typed::tag<uint16_t>(order) == t || 
+                  typed::tag<uint32_t>(order) == t || typed::tag<uint64_t>(order) == t ||
+                  typed::tag<int8_t>(order) == t || typed::tag<int16_t>(order) == t || 
+                  typed::tag<int32_t>(order) == t || typed::tag<int64_t>(order) == t ||
+                  typed::tag<float>(order) == t || typed::tag<double>(order) == t;
+        }
+        ASSERT_TRUE(ok) << t;
+        ASSERT_TRUE(f.valid());
+    }
+}
+
+TEST(Typed, View)
+{
+    std::vector<uint32_t> in(1000);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = i * 100003;
+
+    alignas(8) byte buf[4096 + 16];
+    view c{buf};
+
+    // Payload follows 3 bytes of prefix, tag (2) and head (3)
+    ASSERT_EQ(c.encode_uint(1000), err_ok);
+    ASSERT_EQ(encode_typed(c, in), err_ok);
+    ASSERT_EQ(c.size(), 3 + 2 + 3 + 4000);
+
+    auto it = ++c.begin();
+    ASSERT_EQ((*it).type, type_tag);
+    ASSERT_EQ((*it).tag.num(), typed::tag<uint32_t>());
+
+    auto [v, e] = typed_view<uint32_t>(*it);
+    ASSERT_EQ(e, err_ok);
+    ASSERT_EQ(v.size(), in.size());
+    ASSERT_EQ(v.data(), reinterpret_cast<const uint32_t*>(buf + 8));
+    ASSERT_TRUE(std::equal(v.begin(), v.end(), in.begin()));
+
+    // Other type
+    ASSERT_EQ(std::get<err>(typed_view<int32_t>(*it)), err_invalid_type);
+    ASSERT_EQ(std::get<err>(typed_view<float>(*it)), err_invalid_type);
+    ASSERT_EQ(std::get<err>(typed_view<uint32_t>(*c.begin())), err_invalid_type);
+
+    // Misaligned payload can only be copied
+    c.clear();
+    ASSERT_EQ(encode_typed(c, in), err_ok);
+    ASSERT_EQ(std::get<err>(typed_view<uint32_t>(*c.begin())), err_invalid_type);
+
+    std::vector<uint32_t> out(in.size());
+    auto [n, ec] = typed_copy<uint32_t>(*c.begin(), out);
+    ASSERT_EQ(ec, err_ok);
+    ASSERT_EQ(n, in.size());
+    ASSERT_EQ(out, in);
+
+    // Single bytes are always viewable
+    const int8_t bytes[] = {-1, 2, -3};
+    c.clear();
+    ASSERT_EQ(encode_typed(c, bytes), err_ok);
+    auto [b, eb] = typed_view<int8_t>(*c.begin());
+    ASSERT_EQ(eb, err_ok);
+    ASSERT_EQ(b.size(), 3);
+    ASSERT_EQ(b[2], -3);
+}
+
+TEST(Typed, Copy)
+{
+    // uint16 big endian
+    const byte be[] = { 0xd8, 65, 0x44, 0x01, 0x02, 0x03, 0x04 };
+    auto [obj, e, p] = decode(be, be + sizeof(be));
+    ASSERT_EQ(e, err_ok);
+
+    uint16_t u16[2];
+    ASSERT_EQ(typed_copy<uint16_t>(obj, u16), std::make_tuple(size_t(2), err_ok));
+    ASSERT_EQ(u16[0], 0x0102);
+    ASSERT_EQ(u16[1], 0x0304);
+    if constexpr (std::endian::native == std::endian::little) {
+        ASSERT_EQ(std::get<err>(typed_view<uint16_t>(obj)), err_invalid_type);
+    }
+
+    // Not enough space
+    uint16_t one[1];
+    ASSERT_EQ(typed_copy<uint16_t>(obj, one), std::make_tuple(size_t(2), err_no_memory));
+
+    // Wrong type
+    int16_t s16[2];
+    ASSERT_EQ(std::get<err>(typed_copy<int16_t>(obj, s16)), err_invalid_type);
+
+    // float16 little endian, converted
+    const byte half[] = { 0xd8, 84, 0x44, 0x00, 0x3c, 0x00, 0xc0 };
+    std::tie(obj, e, p) = decode(half, half + sizeof(half));
+    float f32[2];
+    double f64[2];
+    ASSERT_EQ(typed_copy<float>(obj, f32), std::make_tuple(size_t(2), err_ok));
+    ASSERT_EQ(f32[0], 1.0f);
+    ASSERT_EQ(f32[1], -2.0f);
+    ASSERT_EQ(typed_copy<double>(obj, f64), std::make_tuple(size_t(2), err_ok));
+    ASSERT_EQ(f64[1], -2.0);
+
+    // float16 big endian, more than one chunk
+    std::vector<byte> many = { 0xd8, 80, 0x59, 0x01, 0x2c };
+    for (uint16_t i = 0; i < 150; ++i) {
+        uint16_t h = utl::float_to_half(std::bit_cast<uint32_t>(float(i) - 75.5f));
+        many.push_back(h >> 8);
+        many.push_back(h);
+    }
+    std::tie(obj, e, p) = decode(many.data(), many.data() + many.size());
+    std::vector<float> floats(150);
+    std::vector<double> doubles(150);
+    ASSERT_EQ(typed_copy<float>(obj, floats), std::make_tuple(size_t(150), err_ok));
+    ASSERT_EQ(typed_copy<double>(obj, doubles), std::make_tuple(size_t(150), err_ok));
+    for (size_t i = 0; i < 150; ++i) {
+        ASSERT_EQ(floats[i], float(i) - 75.5f);
+        ASSERT_EQ(doubles[i], double(i) - 75.5);
+    }
+
+    // float64 big endian
+    const byte dbl[] = { 0xd8, 82, 0x48, 0x3f, 0xf8, 0, 0, 0, 0, 0, 0 };
+    std::tie(obj, e, p) = decode(dbl, dbl + sizeof(dbl));
+    ASSERT_EQ(typed_copy<double>(obj, f64), std::make_tuple(size_t(1), err_ok));
+    ASSERT_EQ(f64[0], 1.5);
+    ASSERT_EQ(std::get<err>(typed_copy<float>(obj, f32)), err_invalid_type);
+
+    // Payload isn't multiple of element size
+    const byte odd[] = { 0xd8, 70, 0x43, 1, 2, 3 };
+    std::tie(obj, e, p) = decode(odd, odd + sizeof(odd));
+    uint32_t u32[1];
+    ASSERT_EQ(std::get<err>(typed_copy<uint32_t>(obj, u32)), err_invalid_type);
+
+    // Content isn't byte string
+    const byte arr[] = { 0xd8, 64, 0x81, 0x01 };
+    std::tie(obj, e, p) = decode(arr, arr + sizeof(arr));
+    uint8_t u8[1];
+    ASSERT_EQ(std::get<err>(typed_copy<uint8_t>(obj, u8)), err_invalid_type);
+
+    constexpr auto ce = [] {
+        const byte in[] = { 0xd8, 73, 0x42, 0xff, 0xfe };
+        int16_t out[1]{};
+        typed_copy<int16_t>(std::get<item>(decode(in, in + sizeof(in))), out);
+        return out[0];
+    }();
+    static_assert(ce == -2);
+}
+
+TEST(Typed, Gather)
+{
+    std::vector<double> in(1000, 0.5);
+
+    byte buf[64];
+    iovec vec[4];
+    gather_view c{buf, vec};
+
+    ASSERT_EQ(encode_typed(c, in), err_ok);
+
+    auto iov = c.iov();
+    ASSERT_EQ(iov.size(), 2);
+    ASSERT_EQ(iov[1].iov_base, in.data());
+    ASSERT_EQ(iov[1].iov_len, in.size() * sizeof(double));
+}